@@ -0,0 +1,93 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <PerfTest_Category.hpp>
+
+namespace Test {
+
+// Per-allocation latency of the Umpire allocate/deallocate entry points.
+// "by name" is the lookup-per-call path UmpireSpace used to take, "cached"
+// goes through the allocator handle resolved at UmpireSpace construction.
+void run_umpire_allocate_latency(const size_t size, const int R) {
+  Kokkos::UmpireHostSpace space;
+
+  Kokkos::Timer timer;
+  for (int r = 0; r < R; r++) {
+    void* ptr = Kokkos::Impl::umpire_allocate("HOST", size);
+    Kokkos::Impl::umpire_deallocate("HOST", ptr, size);
+  }
+  double time_by_name = timer.seconds();
+
+  timer.reset();
+  for (int r = 0; r < R; r++) {
+    void* ptr = space.allocate(size);
+    space.deallocate(ptr, size);
+  }
+  double time_cached = timer.seconds();
+
+  timer.reset();
+  for (int r = 0; r < R; r++) {
+    Kokkos::View<char*, Kokkos::UmpireHostSpace> v(
+        Kokkos::ViewAllocateWithoutInitializing("v"), size);
+  }
+  double time_view = timer.seconds();
+
+  printf("   UmpireAllocate %8zu B: by name %8.1lf ns  cached %8.1lf ns  "
+         "View %8.1lf ns\n",
+         size, 1.0e9 * time_by_name / R, 1.0e9 * time_cached / R,
+         1.0e9 * time_view / R);
+}
+
+TEST(default_exec, UmpireAllocateLatency) {
+  printf("Allocate/Deallocate latency for UmpireHostSpace:\n");
+  const int R = 100000;
+  for (size_t size = 8; size <= 4096; size *= 8) {
+    run_umpire_allocate_latency(size, R);
+  }
+}
+
+}  // namespace Test
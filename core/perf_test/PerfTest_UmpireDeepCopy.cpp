@@ -0,0 +1,130 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <Kokkos_UmpireSpace_DeepCopyBatch.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <PerfTest_Category.hpp>
+
+namespace Test {
+
+// Bandwidth of HostSpace <-> UmpireHostSpace deep copies, single threaded
+// (parallel copy threshold disabled) and chunked over the host threads.
+void run_umpire_deep_copy_bandwidth(const size_t n, const int R) {
+  Kokkos::View<double*, Kokkos::HostSpace> h("h", n);
+  Kokkos::View<double*, Kokkos::UmpireHostSpace> u("u", n);
+
+  const size_t threshold = Kokkos::Impl::umpire_parallel_copy_threshold();
+  double time[2];
+  for (int parallel = 0; parallel < 2; parallel++) {
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(
+        parallel ? threshold : std::numeric_limits<size_t>::max());
+    Kokkos::Timer timer;
+    for (int r = 0; r < R; r++) {
+      Kokkos::deep_copy(u, h);
+      Kokkos::deep_copy(h, u);
+    }
+    time[parallel] = timer.seconds() / (2 * R);
+  }
+  Kokkos::Impl::umpire_set_parallel_copy_threshold(threshold);
+
+  printf("   UmpireDeepCopy %10zu B: serial %8.3lf GB/s  "
+         "parallel %8.3lf GB/s\n",
+         n * sizeof(double), n * sizeof(double) / time[0] * 1.0e-9,
+         n * sizeof(double) / time[1] * 1.0e-9);
+}
+
+TEST(default_exec, UmpireDeepCopyBandwidth) {
+  printf("Host deep copy bandwidth on %d threads:\n",
+         Kokkos::DefaultHostExecutionSpace().concurrency());
+  for (size_t n : {size_t(1) << 17, size_t(1) << 22, size_t(1) << 27}) {
+    run_umpire_deep_copy_bandwidth(n, n > (size_t(1) << 22) ? 5 : 50);
+  }
+}
+
+// Halo exchange like copies of many small Views into UmpireHostSpace, one
+// deep_copy each versus one deep_copy_batch.
+void run_umpire_deep_copy_batch(const int views, const size_t n, const int R) {
+  using exec_space = Kokkos::DefaultHostExecutionSpace;
+  exec_space exec;
+
+  std::vector<Kokkos::View<double*, Kokkos::HostSpace>> h;
+  std::vector<Kokkos::View<double*, Kokkos::UmpireHostSpace>> u;
+  std::vector<Kokkos::Experimental::DeepCopyBatchEntry<exec_space>> copies;
+  for (int k = 0; k < views; k++) {
+    h.emplace_back("h", n);
+    u.emplace_back("u", n);
+    copies.emplace_back(u.back(), h.back());
+  }
+
+  Kokkos::Timer timer;
+  for (int r = 0; r < R; r++) {
+    for (int k = 0; k < views; k++) Kokkos::deep_copy(exec, u[k], h[k]);
+    exec.fence();
+  }
+  double time_each = timer.seconds() / R;
+
+  timer.reset();
+  for (int r = 0; r < R; r++) {
+    Kokkos::Experimental::deep_copy_batch(exec, copies);
+    exec.fence();
+  }
+  double time_batch = timer.seconds() / R;
+
+  printf("   UmpireDeepCopyBatch %3d x %6zu B: each %8.2lf us  "
+         "batch %8.2lf us\n",
+         views, n * sizeof(double), time_each * 1.0e6, time_batch * 1.0e6);
+}
+
+TEST(default_exec, UmpireDeepCopyBatch) {
+  printf("Many small host to UmpireHostSpace copies per step:\n");
+  for (size_t n : {size_t(64), size_t(1024), size_t(16384)}) {
+    run_umpire_deep_copy_batch(48, n, 1000);
+  }
+}
+
+}  // namespace Test
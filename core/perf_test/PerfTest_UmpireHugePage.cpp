@@ -0,0 +1,109 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Random.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <PerfTest_Category.hpp>
+
+namespace Test {
+
+// Streaming (triad) and random gather kernels over Views allocated from the
+// given Umpire allocator, on the default host execution space.
+void run_umpire_huge_page_kernels(const char* allocator_name, const int N,
+                                  const int R) {
+  using exec_space = Kokkos::DefaultHostExecutionSpace;
+  using view_type  = Kokkos::View<double*, Kokkos::UmpireHostSpace>;
+  using index_type = Kokkos::View<int*, Kokkos::UmpireHostSpace>;
+
+  Kokkos::UmpireHostSpace space(allocator_name);
+
+  view_type a(Kokkos::view_alloc("a", space), N);
+  view_type b(Kokkos::view_alloc("b", space), N);
+  view_type c(Kokkos::view_alloc("c", space), N);
+  index_type idx(Kokkos::view_alloc("idx", space), N);
+
+  Kokkos::Random_XorShift64_Pool<exec_space> pool(12345);
+  Kokkos::fill_random(idx, pool, N);
+  Kokkos::deep_copy(b, 1.0);
+  Kokkos::deep_copy(c, 2.0);
+
+  Kokkos::Timer timer;
+  for (int r = 0; r < R; r++) {
+    Kokkos::parallel_for(
+        "umpire_triad", Kokkos::RangePolicy<exec_space>(0, N),
+        KOKKOS_LAMBDA(const int i) { a(i) = b(i) + 3.0 * c(i); });
+    Kokkos::fence();
+  }
+  double time_stream = timer.seconds() / R;
+
+  timer.reset();
+  double sum = 0;
+  for (int r = 0; r < R; r++) {
+    double partial = 0;
+    Kokkos::parallel_reduce(
+        "umpire_gather", Kokkos::RangePolicy<exec_space>(0, N),
+        KOKKOS_LAMBDA(const int i, double& update) { update += b(idx(i)); },
+        partial);
+    sum += partial;
+  }
+  double time_gather = timer.seconds() / R;
+
+  printf("   %-14s triad %8.3lf GB/s  gather %8.3lf ns/access  (%g)\n",
+         allocator_name, 3.0 * N * sizeof(double) / time_stream * 1.0e-9,
+         time_gather / N * 1.0e9, sum);
+}
+
+TEST(default_exec, UmpireHugePageKernels) {
+  const int N = 1 << 26;  // 512 MiB per double View
+  const int R = 10;
+
+  printf("Triad bandwidth and random gather latency, %d doubles:\n", N);
+  run_umpire_huge_page_kernels("HOST", N, R);
+  run_umpire_huge_page_kernels(Kokkos::Impl::umpire_huge_page_name, N, R);
+  run_umpire_huge_page_kernels(Kokkos::Impl::umpire_hugetlb_name, N, R);
+}
+
+}  // namespace Test
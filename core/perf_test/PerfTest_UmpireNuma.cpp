@@ -0,0 +1,124 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <PerfTest_Category.hpp>
+
+namespace Test {
+
+// Views are allocated without initialization and filled by a single
+// threaded copy from a host View, the way data read on the master thread
+// lands in memory; the triad then runs on the default host execution space.
+void run_umpire_numa_triad(const char* label,
+                           const Kokkos::UmpireHostSpace& space, const int N,
+                           const int R) {
+  using exec_space = Kokkos::DefaultHostExecutionSpace;
+  using view_type  = Kokkos::View<double*, Kokkos::UmpireHostSpace>;
+
+  view_type a(Kokkos::view_alloc("a", space, Kokkos::WithoutInitializing), N);
+  view_type b(Kokkos::view_alloc("b", space, Kokkos::WithoutInitializing), N);
+  view_type c(Kokkos::view_alloc("c", space, Kokkos::WithoutInitializing), N);
+
+  Kokkos::View<double*, Kokkos::HostSpace> h(
+      Kokkos::view_alloc("h", Kokkos::WithoutInitializing), N);
+  for (int i = 0; i < N; i++) h(i) = 1.0;
+  Kokkos::deep_copy(a, h);
+  Kokkos::deep_copy(b, h);
+  Kokkos::deep_copy(c, h);
+
+  Kokkos::Timer timer;
+  for (int r = 0; r < R; r++) {
+    Kokkos::parallel_for(
+        "umpire_numa_triad",
+        Kokkos::RangePolicy<exec_space, Kokkos::Schedule<Kokkos::Static>>(0,
+                                                                          N),
+        KOKKOS_LAMBDA(const int i) { a(i) = b(i) + 3.0 * c(i); });
+    Kokkos::fence();
+  }
+  double time = timer.seconds() / R;
+
+  printf("   %-16s triad %8.3lf GB/s\n", label,
+         3.0 * N * sizeof(double) / time * 1.0e-9);
+}
+
+TEST(default_exec, UmpireNumaTriad) {
+  const int N = 1 << 26;  // 512 MiB per View
+  const int R = 10;
+
+  const int nodes = Kokkos::Impl::umpire_numa_node_count();
+  printf("Triad bandwidth by page placement, %d doubles, %d NUMA node(s):\n",
+         N, nodes);
+  if (nodes == 1) {
+    printf("   (single NUMA node, all placements are equivalent)\n");
+  }
+
+  run_umpire_numa_triad("HOST", Kokkos::UmpireHostSpace(), N, R);
+  run_umpire_numa_triad(
+      "first touch",
+      Kokkos::UmpireHostSpace::make_numa(Kokkos::UmpireNumaPolicy::FirstTouch),
+      N, R);
+#if defined(__linux__)
+  run_umpire_numa_triad(
+      "interleave",
+      Kokkos::UmpireHostSpace::make_numa(Kokkos::UmpireNumaPolicy::Interleave),
+      N, R);
+  run_umpire_numa_triad(
+      "bind first node",
+      Kokkos::UmpireHostSpace::make_numa(
+          Kokkos::UmpireNumaPolicy::Bind,
+          Kokkos::Impl::umpire_numa_nodes().front()),
+      N, R);
+  if (nodes > 1) {
+    run_umpire_numa_triad("bind last node",
+                          Kokkos::UmpireHostSpace::make_numa(
+                              Kokkos::UmpireNumaPolicy::Bind,
+                              Kokkos::Impl::umpire_numa_nodes().back()),
+                          N, R);
+  }
+#endif
+}
+
+}  // namespace Test
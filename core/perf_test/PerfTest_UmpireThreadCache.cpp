@@ -0,0 +1,101 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <PerfTest_Category.hpp>
+
+#if defined(KOKKOS_ENABLE_OPENMP)
+#include <omp.h>
+
+namespace Test {
+
+// Create and destroy R small Views per thread on nthreads OpenMP threads
+// concurrently, returning the aggregate View creations per second.
+template <class MemorySpace>
+double umpire_thread_cache_throughput(const MemorySpace& space,
+                                      const int nthreads, const size_t size,
+                                      const int R) {
+  Kokkos::Timer timer;
+#pragma omp parallel num_threads(nthreads)
+  {
+    for (int r = 0; r < R; r++) {
+      Kokkos::View<char*, MemorySpace> v(
+          Kokkos::view_alloc("v", space, Kokkos::WithoutInitializing), size);
+    }
+  }
+  return nthreads * R / timer.seconds();
+}
+
+TEST(default_exec, UmpireThreadCacheScaling) {
+  const int R           = 20000;
+  const int max_threads = omp_get_max_threads();
+
+  Kokkos::UmpireHostSpace cached = Kokkos::UmpireHostSpace::make_thread_cache();
+
+  printf("View create/destroy throughput (Mviews/s), thread cached "
+         "UmpireHostSpace vs HostSpace:\n");
+  // the View header counts towards the request, so the largest View the
+  // cache serves is smaller than umpire_thread_cache_max_bytes
+  const size_t max_size = Kokkos::Impl::umpire_thread_cache_max_bytes -
+                          sizeof(Kokkos::Impl::SharedAllocationHeader);
+  for (const size_t size : {size_t(64), size_t(256), size_t(1024), max_size}) {
+    // the plain Umpire allocator is not thread safe, so it is only measured
+    // on a single thread as the reference
+    printf("   %5zu B: UmpireHostSpace 1 thread %8.3lf\n", size,
+           1.0e-6 * umpire_thread_cache_throughput(Kokkos::UmpireHostSpace(),
+                                                   1, size, R));
+    for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2) {
+      printf("   %5zu B: %3d threads  cached %8.3lf  HostSpace %8.3lf\n", size,
+             nthreads,
+             1.0e-6 * umpire_thread_cache_throughput(cached, nthreads, size, R),
+             1.0e-6 * umpire_thread_cache_throughput(Kokkos::HostSpace(),
+                                                     nthreads, size, R));
+    }
+  }
+}
+
+}  // namespace Test
+#endif
@@ -0,0 +1,104 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <PerfTest_Category.hpp>
+
+namespace Test {
+
+using umpire_thread_safe_exec = Kokkos::DefaultHostExecutionSpace;
+
+// Allocate and free R blocks of size bytes on each of nthreads threads of
+// the default host execution space (OpenMP, Threads or HPX) at once,
+// returning the aggregate allocations per second.
+template <class MemorySpace>
+double umpire_thread_safe_throughput(const MemorySpace& space,
+                                     const int nthreads, const size_t size,
+                                     const int R) {
+  Kokkos::Timer timer;
+  Kokkos::parallel_for(
+      "umpire_thread_safe_throughput",
+      Kokkos::RangePolicy<umpire_thread_safe_exec,
+                          Kokkos::Schedule<Kokkos::Static>>(0, nthreads),
+      [=](const int) {
+        for (int r = 0; r < R; r++) {
+          space.deallocate(space.allocate(size), size);
+        }
+      });
+  Kokkos::fence();
+  return nthreads * R / timer.seconds();
+}
+
+TEST(default_exec, UmpireThreadSafeScaling) {
+  const int R           = 20000;
+  const int max_threads = umpire_thread_safe_exec().concurrency();
+
+  Kokkos::UmpireHostSpace pool = Kokkos::UmpireHostSpace::make_pool(
+      "umpire_perf_thread_safe_pool", size_t(64) << 20, size_t(64) << 20);
+  // the thread cache up to 4 KiB, the lock of the pool above
+  Kokkos::UmpireHostSpace locked =
+      Kokkos::UmpireHostSpace::make_thread_safe(pool);
+  // one lock per size class up to 64 KiB in between
+  Kokkos::UmpireHostSpace classes = Kokkos::UmpireHostSpace::make_thread_safe(
+      Kokkos::UmpireHostSpace::make_size_classes(64 * 1024, pool));
+
+  printf("Allocation throughput (Mallocs/s) on %s, thread safe "
+         "UmpireHostSpace vs HostSpace:\n",
+         umpire_thread_safe_exec::name());
+  for (size_t size = 256; size <= 64 * 1024; size *= 16) {
+    for (int nthreads = 1; nthreads <= max_threads; nthreads *= 2) {
+      printf("   %6zu B: %3d threads  pool %8.3lf  pool+classes %8.3lf  "
+             "HostSpace %8.3lf\n",
+             size, nthreads,
+             1.0e-6 * umpire_thread_safe_throughput(locked, nthreads, size, R),
+             1.0e-6 * umpire_thread_safe_throughput(classes, nthreads, size, R),
+             1.0e-6 * umpire_thread_safe_throughput(Kokkos::HostSpace(),
+                                                    nthreads, size, R));
+    }
+  }
+}
+
+}  // namespace Test
@@ -0,0 +1,240 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+// Benchmark suite comparing UmpireSpace with HostSpace on the default host
+// execution space (Serial, OpenMP, Threads or HPX):
+//
+//   alloc/<space>/<bytes>            View allocate + free latency
+//   alloc_threads/<space>/<threads>  concurrent raw allocate + free
+//   copy/<dst>_<src>/<bytes>         deep_copy bandwidth
+//   get_record/<space>               SharedAllocationRecord::get_record
+//
+// Results are written as JSON in the layout of Google Benchmark, so runs can
+// be compared with its tools (e.g. compare.py):
+//
+//   KokkosCore_UmpireBenchmark --json=run.json [--min-time=<seconds>]
+//                              [--kokkos-threads=<n>]
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using exec_space = Kokkos::DefaultHostExecutionSpace;
+
+struct Result {
+  std::string name;
+  size_t iterations;
+  double ns_per_iteration;
+  double bytes_per_second;  // 0 if not meaningful
+};
+
+std::vector<Result> s_results;
+double s_min_time = 0.2;
+
+// Run body (which does one iteration, of ops operations, per call) until at
+// least s_min_time seconds have passed, doubling the iterations of each
+// attempt.  Times are reported per operation.
+template <class Body>
+void run(const std::string& name, const size_t bytes, Body body,
+         const size_t ops = 1) {
+  body();  // warm up: first touch, pool growth, caches
+
+  size_t iterations = 1;
+  double time       = 0;
+  while (true) {
+    Kokkos::Timer timer;
+    for (size_t i = 0; i < iterations; i++) body();
+    time = timer.seconds();
+    if (time >= s_min_time || iterations >= (size_t(1) << 30)) break;
+    iterations *= 2;
+  }
+
+  Result result{name, iterations, time / (iterations * ops) * 1.0e9,
+                bytes ? bytes * iterations / time : 0.0};
+  printf("%-48s %12.1lf ns", name.c_str(), result.ns_per_iteration);
+  if (bytes) printf(" %10.3lf GB/s", result.bytes_per_second * 1.0e-9);
+  printf("\n");
+  s_results.push_back(result);
+}
+
+template <class MemorySpace>
+void bench_alloc(const std::string& space_name, const MemorySpace& space) {
+  for (size_t bytes : {size_t(64), size_t(4096), size_t(256) << 10,
+                       size_t(16) << 20}) {
+    run("alloc/" + space_name + "/" + std::to_string(bytes), 0, [&] {
+      Kokkos::View<char*, MemorySpace> v(
+          Kokkos::view_alloc("v", space, Kokkos::WithoutInitializing), bytes);
+    });
+  }
+}
+
+// Raw allocate + free of small blocks on 1, 2, 4, ... threads at once; the
+// time is per allocation on each thread.
+template <class MemorySpace>
+void bench_alloc_threads(const std::string& space_name,
+                         const MemorySpace& space) {
+  const int concurrency = exec_space().concurrency();
+  const int per_thread  = 1000;
+  for (int threads = 1; threads <= concurrency; threads *= 2) {
+    run("alloc_threads/" + space_name + "/" + std::to_string(threads), 0, [&] {
+      Kokkos::parallel_for(
+          "umpire_bench_alloc_threads",
+          Kokkos::RangePolicy<exec_space, Kokkos::Schedule<Kokkos::Static>>(
+              0, threads),
+          [=](const int) {
+            for (int i = 0; i < per_thread; i++) {
+              space.deallocate(space.allocate(256), 256);
+            }
+          });
+      Kokkos::fence();
+    }, per_thread);
+  }
+}
+
+template <class DstSpace, class SrcSpace>
+void bench_copy(const std::string& pair_name, const DstSpace& dst_space,
+                const SrcSpace& src_space) {
+  for (size_t bytes : {size_t(4096), size_t(1) << 20, size_t(64) << 20}) {
+    Kokkos::View<char*, DstSpace> dst(Kokkos::view_alloc("dst", dst_space),
+                                      bytes);
+    Kokkos::View<char*, SrcSpace> src(Kokkos::view_alloc("src", src_space),
+                                      bytes);
+    run("copy/" + pair_name + "/" + std::to_string(bytes), bytes,
+        [&] { Kokkos::deep_copy(dst, src); });
+  }
+}
+
+template <class MemorySpace>
+void bench_get_record(const std::string& space_name,
+                      const MemorySpace& space) {
+  using record_type = Kokkos::Impl::SharedAllocationRecord<MemorySpace, void>;
+  Kokkos::View<double*, MemorySpace> v(Kokkos::view_alloc("v", space), 1000);
+  void* ptr = v.data();
+  run("get_record/" + space_name, 0, [&] {
+    auto* record = record_type::get_record(ptr);
+    // keep the lookup from being optimized away
+    if (record == nullptr) std::abort();
+  });
+}
+
+void write_json(std::ostream& out) {
+  out << "{\n  \"context\": {\n"
+      << "    \"execution_space\": \"" << exec_space::name() << "\",\n"
+      << "    \"concurrency\": " << exec_space().concurrency() << ",\n"
+      << "    \"min_time\": " << s_min_time << "\n  },\n"
+      << "  \"benchmarks\": [";
+  for (size_t i = 0; i < s_results.size(); i++) {
+    const Result& r = s_results[i];
+    out << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name
+        << "\", \"run_name\": \"" << r.name
+        << "\", \"run_type\": \"iteration\", \"iterations\": " << r.iterations
+        << ", \"real_time\": " << r.ns_per_iteration
+        << ", \"cpu_time\": " << r.ns_per_iteration
+        << ", \"time_unit\": \"ns\"";
+    if (r.bytes_per_second > 0) {
+      out << ", \"bytes_per_second\": " << r.bytes_per_second;
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Kokkos::initialize(argc, argv);
+  {
+    std::string json;
+    for (int i = 1; i < argc; i++) {
+      if (!strncmp(argv[i], "--json=", 7)) json = argv[i] + 7;
+      if (!strncmp(argv[i], "--min-time=", 11)) {
+        s_min_time = std::atof(argv[i] + 11);
+      }
+    }
+
+    Kokkos::HostSpace host;
+    Kokkos::UmpireHostSpace umpire;
+    Kokkos::UmpireHostSpace pool = Kokkos::UmpireHostSpace::make_pool(
+        "umpire_bench_pool", size_t(64) << 20, size_t(64) << 20);
+    Kokkos::UmpireHostSpace cache =
+        Kokkos::UmpireHostSpace::make_thread_cache();
+    Kokkos::UmpireHostSpace safe_pool =
+        Kokkos::UmpireHostSpace::make_thread_safe(pool);
+
+    bench_alloc("HostSpace", host);
+    bench_alloc("UmpireHostSpace", umpire);
+    bench_alloc("UmpireHostSpace_pool", pool);
+    bench_alloc("UmpireHostSpace_thread_cache", cache);
+
+    bench_alloc_threads("HostSpace", host);
+    bench_alloc_threads("UmpireHostSpace_thread_cache", cache);
+    bench_alloc_threads("UmpireHostSpace_pool_thread_safe", safe_pool);
+
+    bench_copy("HostSpace_HostSpace", host, host);
+    bench_copy("UmpireHostSpace_HostSpace", umpire, host);
+    bench_copy("HostSpace_UmpireHostSpace", host, umpire);
+    bench_copy("UmpireHostSpace_UmpireHostSpace", umpire, umpire);
+    bench_copy("UmpireHostSpace_pool_HostSpace", pool, host);
+
+    bench_get_record("HostSpace", host);
+    bench_get_record("UmpireHostSpace", umpire);
+
+    if (json.empty()) {
+      write_json(std::cout);
+    } else {
+      std::ofstream out(json);
+      write_json(out);
+    }
+  }
+  Kokkos::finalize();
+  return 0;
+}
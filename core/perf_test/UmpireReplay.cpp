@@ -0,0 +1,388 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+// Replays an UmpireSpace trace (see Kokkos_UmpireSpace_Trace.hpp, recorded
+// with KOKKOS_UMPIRE_TRACE=<file>) against other allocator configurations
+// and reports, for each, the time the allocations and deallocations take,
+// the peak footprint of the allocator and how much of it was unused then.
+// It also breaks the trace down by View label:
+//
+//   KokkosCore_UmpireReplay <trace> [--config=<config>]...
+//                           [--allocator=<name>] [--labels=<n>]
+//
+// A configuration is "host", the plain host allocator, or a comma separated
+// list of
+//
+//   pool=QuickPool|DynamicPoolList   a pool to allocate from
+//   initial=<bytes>,grow=<bytes>     its initial and grow sizes (K, M, G)
+//   size_classes=<bytes>             size classes in front of the pool
+//   device                           in the default device memory space
+//
+// The default configurations are host, pool=QuickPool and
+// pool=DynamicPoolList.  --allocator only replays the allocations the trace
+// made from the named Umpire allocator.  Events are replayed on one thread
+// in the order of their time stamps.
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <Kokkos_UmpireSpace_Trace.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Kokkos::Experimental::UmpireTrace;
+using Kokkos::Experimental::UmpireTraceKind;
+using Kokkos::Experimental::UmpireTraceRecord;
+
+struct Config {
+  std::string text;
+  std::string pool;
+  size_t initial_bytes = size_t(64) << 20;
+  size_t grow_bytes    = size_t(64) << 20;
+  size_t size_classes  = 0;
+  bool device          = false;
+};
+
+struct Result {
+  double seconds = 0;
+  // allocator footprint at its peak, and the bytes requested at the time
+  size_t peak_bytes = 0;
+  size_t used_bytes = 0;
+  // deallocations of allocations made before the trace started
+  size_t unknown = 0;
+};
+
+void fail(const std::string& message) {
+  fprintf(stderr, "KokkosCore_UmpireReplay: %s\n", message.c_str());
+  std::exit(1);
+}
+
+size_t parse_bytes(const std::string& text) {
+  size_t bytes = 0;
+  try {
+    bytes = Kokkos::Impl::umpire_parse_bytes(text, "configuration");
+  } catch (const std::exception& e) {
+    fail(e.what());
+  }
+  return bytes;
+}
+
+Config parse_config(const std::string& text) {
+  Config config;
+  config.text = text;
+  if (text == "host") return config;
+
+  size_t begin = 0;
+  while (begin <= text.size()) {
+    size_t end = text.find(',', begin);
+    if (end == std::string::npos) end = text.size();
+    const std::string item = text.substr(begin, end - begin);
+    const size_t equal     = item.find('=');
+    const std::string key  = item.substr(0, equal);
+    const std::string value =
+        equal == std::string::npos ? std::string() : item.substr(equal + 1);
+
+    if (key == "pool" && (value == "QuickPool" || value == "DynamicPoolList")) {
+      config.pool = value;
+    } else if (key == "initial") {
+      config.initial_bytes = parse_bytes(value);
+    } else if (key == "grow") {
+      config.grow_bytes = parse_bytes(value);
+    } else if (key == "size_classes") {
+      config.size_classes = parse_bytes(value);
+    } else if (key == "device" && value.empty()) {
+      config.device = true;
+    } else {
+      fail("unknown configuration item '" + item + "'");
+    }
+    begin = end + 1;
+  }
+  // the size class pools live as long as the process, so every
+  // configuration gets a pool of its own beneath them
+  if (config.size_classes && config.pool.empty()) {
+    fail("size_classes needs a pool in '" + text + "'");
+  }
+  return config;
+}
+
+template <class Space>
+Space make_space(const Config& config, const int index) {
+  Space space;
+  if (!config.pool.empty()) {
+    const std::string name = "umpire_replay_" + std::to_string(index);
+    const auto strategy    = config.pool == "QuickPool"
+                              ? Kokkos::UmpirePoolStrategy::QuickPool
+                              : Kokkos::UmpirePoolStrategy::DynamicPoolList;
+    space = Space::make_pool(name.c_str(), config.initial_bytes,
+                             config.grow_bytes, strategy);
+  }
+  if (config.size_classes) {
+    space = Space::make_size_classes(config.size_classes, space);
+  }
+  return space;
+}
+
+template <class Space>
+Result replay(const Space& space,
+              const std::vector<UmpireTraceRecord>& events) {
+  Result result;
+  umpire::Allocator allocator = space.get_allocator();
+  // the plain allocators may hold allocations from before
+  const size_t baseline = allocator.getActualSize();
+
+  std::unordered_map<uint64_t, std::pair<void*, size_t>> live;
+  size_t used = 0;
+
+  Kokkos::Timer timer;
+  for (const UmpireTraceRecord& event : events) {
+    uint64_t key = event.ptr;
+    size_t bytes = event.bytes;
+    if (event.kind == UmpireTraceKind::Deallocate ||
+        event.kind == UmpireTraceKind::Reallocate) {
+      auto it = live.find(event.ptr);
+      if (it == live.end()) {
+        ++result.unknown;
+        continue;
+      }
+      space.deallocate(it->second.first, it->second.second);
+      used -= it->second.second;
+      live.erase(it);
+      if (event.kind == UmpireTraceKind::Deallocate) continue;
+      key = event.other_ptr;
+    }
+    if (event.kind == UmpireTraceKind::Allocate ||
+        event.kind == UmpireTraceKind::Reallocate) {
+      live[key] = {space.allocate(bytes), bytes};
+      used += bytes;
+
+      const size_t actual = allocator.getActualSize() - baseline;
+      if (actual > result.peak_bytes) {
+        result.peak_bytes = actual;
+        result.used_bytes = used;
+      }
+    }
+  }
+  for (const auto& allocation : live) {
+    space.deallocate(allocation.second.first, allocation.second.second);
+  }
+  result.seconds = timer.seconds();
+  return result;
+}
+
+struct LabelSummary {
+  size_t allocations = 0;
+  size_t bytes       = 0;
+  size_t copied_to   = 0;
+  size_t copied_from = 0;
+};
+
+// Allocations, and bytes copied into and out of them, by View label; copies
+// are attributed to the live allocations they fall into.
+std::map<std::string, LabelSummary> summarize(
+    const UmpireTrace& trace, const std::vector<UmpireTraceRecord>& events) {
+  std::map<std::string, LabelSummary> labels;
+  std::map<uint64_t, std::pair<size_t, uint32_t>> live;
+
+  auto label_of = [&](const uint64_t ptr) -> const std::string* {
+    auto it = live.upper_bound(ptr);
+    if (it == live.begin()) return nullptr;
+    --it;
+    if (ptr >= it->first + it->second.first) return nullptr;
+    return &trace.names[it->second.second];
+  };
+
+  for (const UmpireTraceRecord& event : events) {
+    switch (event.kind) {
+      case UmpireTraceKind::Allocate: {
+        LabelSummary& label = labels[trace.names[event.label]];
+        ++label.allocations;
+        label.bytes += event.bytes;
+        live[event.ptr] = {event.bytes, event.label};
+        break;
+      }
+      case UmpireTraceKind::Reallocate: {
+        auto it = live.find(event.ptr);
+        if (it == live.end()) break;
+        const uint32_t label = it->second.second;
+        live.erase(it);
+        live[event.other_ptr] = {event.bytes, label};
+        break;
+      }
+      case UmpireTraceKind::Deallocate: live.erase(event.ptr); break;
+      case UmpireTraceKind::Copy: {
+        if (const std::string* label = label_of(event.ptr)) {
+          labels[*label].copied_to += event.bytes;
+        }
+        if (const std::string* label = label_of(event.other_ptr)) {
+          labels[*label].copied_from += event.bytes;
+        }
+        break;
+      }
+      default: break;
+    }
+  }
+  return labels;
+}
+
+double mib(const size_t bytes) { return bytes / double(1 << 20); }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Kokkos::initialize(argc, argv);
+  {
+    std::string file_name;
+    std::string allocator_name;
+    std::vector<Config> configs;
+    size_t max_labels = 20;
+    for (int i = 1; i < argc; i++) {
+      if (!strncmp(argv[i], "--config=", 9)) {
+        configs.push_back(parse_config(argv[i] + 9));
+      } else if (!strncmp(argv[i], "--allocator=", 12)) {
+        allocator_name = argv[i] + 12;
+      } else if (!strncmp(argv[i], "--labels=", 9)) {
+        max_labels = std::atoi(argv[i] + 9);
+      } else if (strncmp(argv[i], "--", 2)) {
+        file_name = argv[i];
+      }
+    }
+    if (file_name.empty()) fail("no trace file given");
+    if (configs.empty()) {
+      for (const char* text :
+           {"host", "pool=QuickPool", "pool=DynamicPoolList"}) {
+        configs.push_back(parse_config(text));
+      }
+    }
+
+    UmpireTrace trace;
+    if (!Kokkos::Experimental::umpire_read_trace(file_name, trace)) {
+      fail(file_name + " is not an UmpireSpace trace, or is corrupted");
+    }
+
+    // the threads wrote their records in batches
+    std::vector<UmpireTraceRecord> events = trace.records;
+    auto by_time = [](const UmpireTraceRecord& a, const UmpireTraceRecord& b) {
+      return a.time_ns < b.time_ns;
+    };
+    std::stable_sort(events.begin(), events.end(), by_time);
+
+    std::vector<UmpireTraceRecord> replayed;
+    size_t counts[5] = {};
+    size_t copy_bytes = 0;
+    uint32_t threads  = 0;
+    for (const UmpireTraceRecord& event : events) {
+      ++counts[int(event.kind)];
+      threads = std::max(threads, event.thread + 1);
+      if (event.kind == UmpireTraceKind::Copy) {
+        copy_bytes += event.bytes;
+      } else if (allocator_name.empty() ||
+                 trace.names[event.allocator] == allocator_name) {
+        replayed.push_back(event);
+      }
+    }
+
+    printf("%s: %zu events on %u threads over %.3lf s\n", file_name.c_str(),
+           events.size(), threads,
+           events.empty() ? 0.0 : events.back().time_ns * 1.0e-9);
+    printf("  %zu allocations, %zu deallocations, %zu reallocations, "
+           "%zu copies of %.1lf MiB\n",
+           counts[int(UmpireTraceKind::Allocate)],
+           counts[int(UmpireTraceKind::Deallocate)],
+           counts[int(UmpireTraceKind::Reallocate)],
+           counts[int(UmpireTraceKind::Copy)], mib(copy_bytes));
+
+    printf("\n%-44s %10s %10s %10s %8s\n", "configuration", "time [ms]",
+           "peak [MiB]", "used [MiB]", "unused");
+    for (size_t i = 0; i < configs.size(); i++) {
+      const Config& config = configs[i];
+      using host_space     = Kokkos::UmpireHostSpace;
+      using device_space =
+          Kokkos::UmpireSpace<Kokkos::DefaultExecutionSpace::memory_space>;
+      const Result result =
+          config.device
+              ? replay(make_space<device_space>(config, i), replayed)
+              : replay(make_space<host_space>(config, i), replayed);
+      // share of the peak footprint not requested at the time
+      const double unused =
+          result.peak_bytes ? 100.0 * (result.peak_bytes - result.used_bytes) /
+                                  result.peak_bytes
+                            : 0.0;
+      printf("%-44s %10.3lf %10.1lf %10.1lf %7.1lf%%\n", config.text.c_str(),
+             result.seconds * 1.0e3, mib(result.peak_bytes),
+             mib(result.used_bytes), unused);
+      if (result.unknown) {
+        printf("  (%zu deallocations of allocations from before the trace)\n",
+               result.unknown);
+      }
+    }
+
+    const auto labels = summarize(trace, events);
+    std::vector<std::pair<std::string, LabelSummary>> by_bytes(labels.begin(),
+                                                               labels.end());
+    std::sort(by_bytes.begin(), by_bytes.end(),
+              [](const auto& a, const auto& b) {
+                return a.second.bytes > b.second.bytes;
+              });
+    if (by_bytes.size() > max_labels) by_bytes.resize(max_labels);
+
+    printf("\n%-40s %8s %12s %12s %12s\n", "label", "allocs", "bytes [MiB]",
+           "to [MiB]", "from [MiB]");
+    for (const auto& label : by_bytes) {
+      printf("%-40s %8zu %12.1lf %12.1lf %12.1lf\n",
+             label.first.empty() ? "(none)" : label.first.c_str(),
+             label.second.allocations, mib(label.second.bytes),
+             mib(label.second.copied_to), mib(label.second.copied_from));
+    }
+  }
+  Kokkos::finalize();
+  return 0;
+}
@@ -44,10 +44,15 @@
 #ifndef KOKKOS_UMPIRESPACE_HPP
 #define KOKKOS_UMPIRESPACE_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <cstring>
+#include <functional>
 #include <string>
 #include <iosfwd>
+#include <memory>
 #include <typeinfo>
+#include <vector>
 
 #include <Kokkos_Core_fwd.hpp>
 #include <Kokkos_Concepts.hpp>
@@ -65,19 +70,482 @@
 
 namespace Kokkos {
 
+/// Umpire pool strategies an UmpireSpace can be backed by, see
+/// UmpireSpace::make_pool
+enum class UmpirePoolStrategy { QuickPool, DynamicPoolList };
+
+/// Page placement policies for UmpireSpace::make_numa
+enum class UmpireNumaPolicy { Interleave, Bind, FirstTouch };
+
+/// Access pattern hint (madvise) for the files of UmpireSpace::make_file
+enum class UmpireFileAccess { Normal, Sequential, Random };
+
+/// Options of the files backing an UmpireSpace::make_file space
+struct UmpireFileOptions {
+  //! directory of the files, $TMPDIR (or /tmp) if empty
+  std::string directory;
+  //! sparse files get disk blocks as pages are written back, the others
+  //! all of them up front, so running out of disk space fails allocation
+  bool sparse = true;
+  UmpireFileAccess access = UmpireFileAccess::Normal;
+};
+
+/// Allocation statistics of the UmpireSpaces allocating from one Umpire
+/// allocator, see UmpireSpace::statistics
+struct UmpireSpaceStatistics {
+  std::string allocator_name;
+  //! bytes taken from the allocator and not returned yet
+  size_t current_bytes = 0;
+  //! high-water mark of current_bytes
+  size_t peak_bytes    = 0;
+  size_t allocations   = 0;
+  size_t deallocations = 0;
+  //! part of current_bytes taken by View headers and alignment padding
+  size_t overhead_bytes = 0;
+};
+
+/// When the free memory of an Umpire allocator, e.g. the unused blocks of a
+/// pool, is released to its upstream allocator, see
+/// UmpireSpace::set_release_policy
+struct UmpireReleasePolicy {
+  //! at umpire_release_point() and Kokkos::finalize
+  bool at_release_points = false;
+  //! when a deallocation leaves more than free_bytes free (0: never); after
+  //! a release, once free_bytes more than were left are free again
+  size_t free_bytes = 0;
+  //! when the "some avg10" memory pressure of /proc/pressure/memory exceeds
+  //! pressure_percent (0: never; Linux only), polled by deallocations at
+  //! most every pressure_interval seconds
+  double pressure_percent  = 0;
+  double pressure_interval = 1.0;
+};
+
+/**\brief  Release the free memory of every Umpire allocator whose release
+ *         policy asks for it at release points, e.g. after a Kokkos::fence
+ *         that ends a peak phase of a run.
+ */
+void umpire_release_point();
+
+/**\brief  Statistics of every Umpire allocator UmpireSpaces allocated from.
+ *
+ *  They are printed at finalize when the environment variable
+ *  KOKKOS_UMPIRE_STATISTICS is set to a non-zero value.
+ */
+std::vector<UmpireSpaceStatistics> umpire_space_statistics();
+void print_umpire_space_statistics(std::ostream&);
+
+/**\brief  Move the startup cost of Umpire out of the first View
+ *         allocations: resolve the default allocators and those listed,
+ *         and create the pools listed with their initial blocks acquired
+ *         and touched.
+ *
+ *  The lists are read from the JSON file named by the environment variable
+ *  KOKKOS_UMPIRE_CONFIG and from KOKKOS_UMPIRE_ALLOCATORS and
+ *  KOKKOS_UMPIRE_POOLS (see the README for the formats).  Call it right
+ *  after Kokkos::initialize, so that host pages are touched in parallel.
+ *  The first call also starts the trace KOKKOS_UMPIRE_TRACE asks for (see
+ *  umpire_trace_start).
+ */
+void umpire_prewarm();
+
+/**\brief  umpire_prewarm with the lists from the JSON file config_file */
+void umpire_prewarm(const std::string& config_file);
+
+/// A pool made by UmpireSpace::make_pool acquiring a block from (Grow) or
+/// returning a block to (Release) its upstream allocator
+enum class UmpirePoolEventKind { Grow, Release };
+
+struct UmpirePoolEvent {
+  const char* pool_name;
+  UmpirePoolEventKind kind;
+  const void* block;
+  size_t bytes;
+};
+
+/**\brief  Have callback called, on the allocating thread, for every pool
+ *         event; an empty function removes it.
+ *
+ *  Pool events are also reported to Kokkos Tools, as allocateData and
+ *  deallocateData of the blocks labeled with the pool name, in the space
+ *  "Umpire:<upstream allocator name>".
+ */
+void set_umpire_pool_event_callback(
+    std::function<void(const UmpirePoolEvent&)> callback);
+
 namespace Impl {
 
 void umpire_to_umpire_deep_copy(void*, const void*, size_t, bool offset = true);
 void host_to_umpire_deep_copy(void*, const void*, size_t, bool offset = true);
 void umpire_to_host_deep_copy(void*, const void*, size_t, bool offset = true);
 void* umpire_allocate(const char*, size_t);
+void* umpire_allocate(umpire::Allocator&, size_t);
+void* umpire_allocate_aligned(umpire::Allocator&, size_t, size_t alignment,
+                              bool host_accessible);
 void umpire_deallocate(const char* name, void* const arg_alloc_ptr,
                        const size_t);
+void umpire_deallocate(umpire::Allocator& allocator, void* const arg_alloc_ptr,
+                       const size_t);
+void umpire_deallocate_aligned(umpire::Allocator& allocator,
+                               void* const arg_alloc_ptr, const size_t,
+                               bool host_accessible);
+void* umpire_reallocate(umpire::Allocator&, void* const, const size_t);
+void* umpire_reallocate_aligned(umpire::Allocator&, void* const,
+                                const size_t old_size, const size_t new_size,
+                                size_t alignment);
+
+/* UmpireAllocatorAlignment - the alignment an Umpire allocator guarantees
+ * by itself: alignment for every request and, for the strategies mapping
+ * whole pages, mapped_alignment for requests of at least mapped_threshold
+ * bytes.
+ */
+struct UmpireAllocatorAlignment {
+  size_t alignment        = alignof(std::max_align_t);
+  size_t mapped_alignment = 0;
+  size_t mapped_threshold = 0;
+
+  size_t of(const size_t bytes) const {
+    return mapped_alignment && bytes >= mapped_threshold ? mapped_alignment
+                                                         : alignment;
+  }
+};
+UmpireAllocatorAlignment umpire_allocator_alignment(umpire::Allocator);
+constexpr size_t umpire_pool_alignment = Kokkos::Impl::MEMORY_ALIGNMENT;
 umpire::Allocator get_allocator(const char* name);
 
+/* umpire_parse_bytes - a byte count, either a plain number or one with a
+ * binary K, M or G suffix ("256M"); throws naming what otherwise.
+ */
+size_t umpire_parse_bytes(const std::string& text, const std::string& what);
+
+/* Allocators provided by Kokkos rather than Umpire, created on first use:
+ *   HOST_ALIGNED  - host memory aligned to MEMORY_ALIGNMENT, the default
+ *                   allocator of UmpireHostSpace and the fallback of the
+ *                   allocators below for requests they do not map
+ *   HOST_HUGEPAGE - host memory, requests of at least
+ *                   umpire_huge_page_threshold bytes are mapped 2 MiB aligned
+ *                   and advised to use transparent huge pages
+ *   HOST_HUGETLB  - like HOST_HUGEPAGE but tries explicit (MAP_HUGETLB) huge
+ *                   pages first
+ */
+constexpr const char* umpire_host_aligned_name = "HOST_ALIGNED";
+umpire::Allocator umpire_host_aligned_allocator();
+constexpr const char* umpire_huge_page_name = "HOST_HUGEPAGE";
+constexpr const char* umpire_hugetlb_name   = "HOST_HUGETLB";
+constexpr size_t umpire_huge_page_bytes     = 2 * 1024 * 1024;
+constexpr size_t umpire_huge_page_threshold = umpire_huge_page_bytes;
+bool umpire_make_huge_page_allocator(const char* name);
+
+/*   HOST_NUMA_INTERLEAVE - host memory, the pages of requests of at least
+ *                          umpire_numa_threshold bytes are interleaved over
+ *                          the online NUMA nodes
+ *   HOST_NUMA_BIND_<n>   - host memory, such pages are bound to NUMA node n
+ */
+constexpr const char* umpire_numa_interleave_name = "HOST_NUMA_INTERLEAVE";
+constexpr const char* umpire_numa_bind_prefix     = "HOST_NUMA_BIND_";
+constexpr size_t umpire_numa_threshold            = 64 * 1024;
+constexpr size_t umpire_first_touch_min_bytes     = 256 * 1024;
+bool umpire_make_numa_allocator(const char* name);
+umpire::Allocator umpire_numa_allocator(UmpireNumaPolicy policy, int node);
+
+/*   HOST_FILE[_FULL][_SEQUENTIAL|_RANDOM][:<directory>]
+ *        - host memory, requests of at least umpire_file_threshold bytes are
+ *          mapped from files in directory ($TMPDIR or /tmp by default), see
+ *          UmpireFileOptions for the flags.  The files are unlinked right
+ *          away and go away with their mapping.
+ */
+constexpr const char* umpire_file_prefix = "HOST_FILE";
+constexpr size_t umpire_file_threshold   = 64 * 1024;
+bool umpire_make_file_allocator(const char* name);
+std::string umpire_file_allocator_name(const UmpireFileOptions& options);
+
+/*   HOST_SHARED[:<prefix>]
+ *        - host memory in POSIX shared memory segments that other processes
+ *          on the node can attach to, one per allocation, named
+ *          "/<prefix>.<label>:<pid>.<serial>" after the View label.  The
+ *          prefix defaults to umpire_shared_default_prefix.
+ */
+constexpr const char* umpire_shared_prefix         = "HOST_SHARED";
+constexpr const char* umpire_shared_default_prefix = "kokkos_umpire";
+bool umpire_make_shared_allocator(const char* name);
+std::string umpire_shared_allocator_name(const char* prefix);
+void umpire_shared_publish(void* segment, const void* data, size_t bytes);
+void* umpire_shared_attach(umpire::Allocator allocator, const char* label,
+                           bool read_only, size_t& bytes);
+void umpire_shared_detach(const void* data);
+
+/* UmpireNamedAllocation - names the allocations made on this thread during
+ * its lifetime after a View label, for the strategies that need a name.
+ * The node shared strategy names its segment after it and leaves the
+ * segment here, so that the View data can be published in it.
+ */
+class UmpireNamedAllocation {
+ public:
+  explicit UmpireNamedAllocation(const char* name)
+      : m_name(name), m_previous(s_current) {
+    s_current = this;
+  }
+  ~UmpireNamedAllocation() { s_current = m_previous; }
+
+  UmpireNamedAllocation(const UmpireNamedAllocation&) = delete;
+  UmpireNamedAllocation& operator=(const UmpireNamedAllocation&) = delete;
+
+  static UmpireNamedAllocation* current() { return s_current; }
+  const char* name() const { return m_name; }
+
+  void* segment = nullptr;
+
+ private:
+  const char* const m_name;
+  UmpireNamedAllocation* const m_previous;
+  static inline thread_local UmpireNamedAllocation* s_current = nullptr;
+};
+const std::vector<int>& umpire_numa_nodes();
+int umpire_numa_node_count();
+void umpire_first_touch(void* ptr, size_t size);
+class UmpireThreadCache;
+constexpr size_t umpire_thread_cache_min_bytes = 64;
+constexpr size_t umpire_thread_cache_max_bytes = 4096;
+UmpireThreadCache* umpire_thread_cache(umpire::Allocator);
+void* umpire_thread_cache_allocate(UmpireThreadCache*, size_t);
+void umpire_thread_cache_deallocate(UmpireThreadCache*, void* const,
+                                    const size_t);
+class UmpireSizeClasses;
+constexpr size_t umpire_size_class_min_bytes         = 64;
+constexpr size_t umpire_size_class_default_max_bytes = 4096;
+UmpireSizeClasses* umpire_size_classes(umpire::Allocator, size_t max_bytes);
+void* umpire_size_class_allocate(UmpireSizeClasses*, size_t);
+void umpire_size_class_deallocate(UmpireSizeClasses*, void* const,
+                                  const size_t);
+class UmpireArena;
+std::shared_ptr<UmpireArena> umpire_make_arena(umpire::Allocator, size_t,
+                                               size_t alignment);
+void* umpire_arena_allocate(UmpireArena*, size_t);
+void umpire_arena_deallocate(UmpireArena*);
+void* umpire_arena_reallocate(UmpireArena*, void* const, size_t, size_t);
+void umpire_arena_reset(UmpireArena*);
+umpire::Allocator umpire_make_pool_upstream(const char* pool_name,
+                                            umpire::Allocator upstream);
+umpire::Allocator umpire_make_pool(const char* name,
+                                   umpire::Allocator upstream,
+                                   size_t initial_bytes, size_t grow_bytes,
+                                   UmpirePoolStrategy strategy);
+void umpire_check_copy_bounds(const void*, size_t);
+umpire::Allocator umpire_make_thread_safe(umpire::Allocator);
+bool umpire_is_thread_safe(umpire::Allocator);
+size_t umpire_release(umpire::Allocator);
+class UmpireReleaser;
+struct UmpireSpaceCounters;
+void umpire_set_release_policy(umpire::Allocator, UmpireSpaceCounters*,
+                               const UmpireReleasePolicy&);
+void umpire_release_check(UmpireReleaser*);
+
+/* Counters behind UmpireSpaceStatistics, one set per Umpire allocator,
+ * updated with relaxed atomics by every allocate / deallocate of a space,
+ * so they never serialize threads on a lock.  The high-water mark is read
+ * on every allocation but rarely written, so it gets a cache line of its
+ * own.
+ */
+struct UmpireSpaceCounters {
+  explicit UmpireSpaceCounters(const std::string& name)
+      : allocator_name(name) {}
+
+  void allocated(const size_t bytes, const size_t overhead) {
+    const size_t current =
+        current_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (overhead) add_overhead(overhead);
+
+    size_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (peak < current &&
+           !peak_bytes.compare_exchange_weak(peak, current,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  void deallocated(const size_t bytes, const size_t overhead) {
+    current_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    deallocations.fetch_add(1, std::memory_order_relaxed);
+    if (overhead) remove_overhead(overhead);
+  }
+
+  void resized(const size_t old_bytes, const size_t new_bytes) {
+    if (new_bytes < old_bytes) {
+      current_bytes.fetch_sub(old_bytes - new_bytes, std::memory_order_relaxed);
+      return;
+    }
+    const size_t current =
+        current_bytes.fetch_add(new_bytes - old_bytes,
+                                std::memory_order_relaxed) +
+        new_bytes - old_bytes;
+
+    size_t peak = peak_bytes.load(std::memory_order_relaxed);
+    while (peak < current &&
+           !peak_bytes.compare_exchange_weak(peak, current,
+                                             std::memory_order_relaxed)) {
+    }
+  }
+
+  void add_overhead(const size_t bytes) {
+    overhead_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  void remove_overhead(const size_t bytes) {
+    overhead_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  UmpireSpaceStatistics statistics() const;
+
+  const std::string allocator_name;
+  std::atomic<size_t> current_bytes{0};
+  std::atomic<size_t> allocations{0};
+  std::atomic<size_t> deallocations{0};
+  std::atomic<size_t> overhead_bytes{0};
+  alignas(64) std::atomic<size_t> peak_bytes{0};
+  // release policy of the allocator, if any; read by every deallocation
+  std::atomic<UmpireReleaser*> releaser{nullptr};
+};
+
+UmpireSpaceCounters* umpire_space_counters(const umpire::Allocator&);
+
+/* Host side mirrors of the SharedAllocationHeader of allocations in Umpire
+ * spaces that are not host accessible, keyed by the header address, so that
+ * record and label lookups do not have to copy the header back.  While a
+ * Kokkos Tools library is loaded the headers of host accessible allocations
+ * are mirrored as well, so that deep copies can be reported with the labels
+ * of their Views.
+ */
+void umpire_header_mirror_insert(const SharedAllocationHeader*,
+                                 const SharedAllocationHeader&);
+void umpire_header_mirror_erase(const SharedAllocationHeader*);
+bool umpire_header_mirror_find(const SharedAllocationHeader*,
+                               SharedAllocationHeader&);
+
+// set while an UmpireSpace trace is written, see umpire_trace_start
+inline std::atomic<bool> umpire_trace_active{false};
+void umpire_trace_allocate(const umpire::Allocator&, const void*, size_t);
+void umpire_trace_deallocate(const umpire::Allocator&, const void*, size_t);
+void umpire_trace_reallocate(const umpire::Allocator&, const void* old_ptr,
+                             const void* ptr, size_t old_size,
+                             size_t new_size);
+void umpire_trace_copy(const void* dst, const void* src, size_t);
+void umpire_trace_start_from_environment();
+
+void umpire_begin_deep_copy(const void* dst, bool dst_is_umpire,
+                            const void* src, bool src_is_umpire, size_t n);
+void umpire_end_deep_copy();
+
+/* UmpireDeepCopyProfile - reports a deep copy to Kokkos Tools, if a tool is
+ * loaded, for the lifetime of the object.  The space handles name the Umpire
+ * allocator of each Umpire side ("Umpire:<allocator name>"), and a side that
+ * is the data of an Umpire View carries the label of the View.  Copies
+ * ordered on an execution space instance end their report when they are
+ * enqueued, as Kokkos::deep_copy(exec, ...) does: the reported time is the
+ * submission time only, the copy itself completes with the next fence.
+ */
+class UmpireDeepCopyProfile {
+ public:
+  UmpireDeepCopyProfile(const void* dst, const bool dst_is_umpire,
+                        const void* src, const bool src_is_umpire,
+                        const size_t n) {
+    if (umpire_trace_active.load(std::memory_order_relaxed)) {
+      umpire_trace_copy(dst, src, n);
+    }
+#if defined(KOKKOS_ENABLE_PROFILING)
+    if (Kokkos::Profiling::profileLibraryLoaded()) {
+      m_active = true;
+      umpire_begin_deep_copy(dst, dst_is_umpire, src, src_is_umpire, n);
+    }
+#else
+    (void)dst, (void)dst_is_umpire, (void)src, (void)src_is_umpire, (void)n;
+#endif
+  }
+
+  ~UmpireDeepCopyProfile() {
+    if (m_active) umpire_end_deep_copy();
+  }
+
+  UmpireDeepCopyProfile(const UmpireDeepCopyProfile&) = delete;
+  UmpireDeepCopyProfile& operator=(const UmpireDeepCopyProfile&) = delete;
+
+ private:
+  bool m_active = false;
+};
+
+/* Host accessible copies of at least umpire_parallel_copy_threshold() bytes
+ * are split into page aligned chunks copied in parallel on the default host
+ * execution space.  The threshold defaults to 1 MiB and can be set with the
+ * KOKKOS_UMPIRE_PARALLEL_COPY_THRESHOLD environment variable or
+ * umpire_set_parallel_copy_threshold.
+ */
+size_t umpire_parallel_copy_threshold();
+void umpire_set_parallel_copy_threshold(size_t bytes);
+// false inside parallel regions, where copies and fills are not chunked
+bool umpire_host_can_dispatch();
+void umpire_host_parallel_deep_copy(void* dst, const void* src, size_t n);
+void umpire_host_deep_copy_async(const Kokkos::DefaultHostExecutionSpace&,
+                                 void* dst, const void* src, size_t n);
+
+/* Fills: host accessible ones are memsets, chunked like copies above the
+ * parallel copy threshold, the others use the Umpire MEMSET operation.
+ * umpire_is_fresh_mapping tells whether [ptr, ptr + n), allocated right
+ * before from allocator, lies in freshly mapped (zero) pages.
+ */
+void umpire_host_fill(void* ptr, int value, size_t n);
+void umpire_memset(void* ptr, int value, size_t n);
+bool umpire_is_fresh_mapping(umpire::Allocator&, const void* ptr, size_t n);
+
+/* host_accessible_deep_copy - both sides of the copy are host accessible
+ *                             (known from the DeepCopy<> specialization),
+ *                             so the Umpire COPY operation would end in a
+ *                             plain memcpy anyway.  The allocation records
+ *                             are only consulted for bounds checking in debug
+ *                             builds.
+ */
+template <bool DstIsUmpire, bool SrcIsUmpire>
+inline void host_accessible_deep_copy(void* dst, const void* src, size_t n) {
+  UmpireDeepCopyProfile profile(dst, DstIsUmpire, src, SrcIsUmpire, n);
+#ifdef KOKKOS_DEBUG
+  if (DstIsUmpire) umpire_check_copy_bounds(dst, n);
+  if (SrcIsUmpire) umpire_check_copy_bounds(src, n);
+#endif
+  if (n >= umpire_parallel_copy_threshold()) {
+    umpire_host_parallel_deep_copy(dst, src, n);
+  } else if (n > 0) {
+    std::memcpy(dst, src, n);
+  }
+}
+
+/* host_accessible_deep_copy(exec, ...) - the copy is ordered after the work
+ *                             submitted to exec before it.  On the default
+ *                             host execution space it is enqueued on the
+ *                             instance like a kernel, so it neither drains
+ *                             nor waits for other instances, and Kokkos
+ *                             Tools see its submission only.  Any other
+ *                             execution space is fenced once, before the
+ *                             (synchronous) copy.
+ */
+template <bool DstIsUmpire, bool SrcIsUmpire, class ExecutionSpace>
+inline void host_accessible_deep_copy(const ExecutionSpace& exec, void* dst,
+                                      const void* src, size_t n) {
+  if constexpr (std::is_same<ExecutionSpace,
+                             Kokkos::DefaultHostExecutionSpace>::value) {
+    UmpireDeepCopyProfile profile(dst, DstIsUmpire, src, SrcIsUmpire, n);
+#ifdef KOKKOS_DEBUG
+    if (DstIsUmpire) umpire_check_copy_bounds(dst, n);
+    if (SrcIsUmpire) umpire_check_copy_bounds(src, n);
+#endif
+    if (n > 0) umpire_host_deep_copy_async(exec, dst, src, n);
+  } else {
+    exec.fence();
+    host_accessible_deep_copy<DstIsUmpire, SrcIsUmpire>(dst, src, n);
+  }
+}
+
 template <class MemorySpace>
 inline const char* umpire_space_name(const MemorySpace& default_device) {
-  if (std::is_same<MemorySpace, Kokkos::HostSpace>::value) return "HOST";
+  if (std::is_same<MemorySpace, Kokkos::HostSpace>::value) {
+    return umpire_host_aligned_name;
+  }
 #if defined(KOKKOS_ENABLE_CUDA)
   if (std::is_same<MemorySpace, Kokkos::CudaSpace>::value) return "DEVICE";
   if (std::is_same<MemorySpace, Kokkos::CudaUVMSpace>::value) return "UM";
@@ -85,6 +553,31 @@ inline const char* umpire_space_name(const MemorySpace& default_device) {
     return "HOSTPINNED";
 #endif
 }
+
+/* The ResourceManager lookup is keyed by string, so resolve the default
+ * allocator of each upstream memory space once per process instead of on
+ * every default constructed UmpireSpace (i.e. every View allocation).
+ */
+template <class MemorySpace>
+inline umpire::Allocator umpire_default_allocator() {
+  static const umpire::Allocator s_allocator =
+      get_allocator(umpire_space_name(MemorySpace()));
+  return s_allocator;
+}
+
+template <class MemorySpace>
+inline UmpireAllocatorAlignment umpire_default_allocator_alignment() {
+  static const UmpireAllocatorAlignment s_alignment =
+      umpire_allocator_alignment(umpire_default_allocator<MemorySpace>());
+  return s_alignment;
+}
+
+template <class MemorySpace>
+inline UmpireSpaceCounters* umpire_default_allocator_counters() {
+  static UmpireSpaceCounters* const s_counters =
+      umpire_space_counters(umpire_default_allocator<MemorySpace>());
+  return s_counters;
+}
 }  // namespace Impl
 
 /// \class UmpireSpace
@@ -105,14 +598,273 @@ class UmpireSpace {
   typedef Kokkos::Device<execution_space, memory_space> device_type;
 
   /**\brief  Default memory space instance */
-  explicit UmpireSpace(const char* name_) : m_AllocatorName(name_) {
+  explicit UmpireSpace(const char* name_)
+      : m_AllocatorName(name_),
+        m_Allocator(Impl::get_allocator(name_)),
+        m_AllocatorAlignment(Impl::umpire_allocator_alignment(m_Allocator)),
+        m_Counters(Impl::umpire_space_counters(m_Allocator)) {
     // somehow need to check that the name is consistent with the upstream
     // memory space
   }
 
   /* Default allocation mechanism, assume the Umpire allocator is HOST */
   UmpireSpace()
-      : m_AllocatorName(Impl::umpire_space_name(upstream_memory_space())) {}
+      : m_AllocatorName(Impl::umpire_space_name(upstream_memory_space())),
+        m_Allocator(Impl::umpire_default_allocator<upstream_memory_space>()),
+        m_AllocatorAlignment(
+            Impl::umpire_default_allocator_alignment<upstream_memory_space>()),
+        m_Counters(
+            Impl::umpire_default_allocator_counters<upstream_memory_space>()) {
+  }
+
+  /**\brief  Memory space allocating from an existing Umpire allocator */
+  explicit UmpireSpace(const umpire::Allocator& allocator_)
+      : m_AllocatorName(allocator_.getName().c_str()),
+        m_Allocator(allocator_),
+        m_AllocatorAlignment(Impl::umpire_allocator_alignment(m_Allocator)),
+        m_Counters(Impl::umpire_space_counters(m_Allocator)) {}
+
+  /**\brief  Create (or look up) a pool named name_ on top of the default
+   *         Umpire resource of the upstream memory space, and return a
+   *         memory space allocating from it.
+   *
+   *  initial_bytes_ is the size of the first block the pool acquires from
+   *  the resource, grow_bytes_ the minimum size of each further block.
+   */
+  static UmpireSpace make_pool(
+      const char* name_, const size_t initial_bytes_, const size_t grow_bytes_,
+      const UmpirePoolStrategy strategy_ = UmpirePoolStrategy::QuickPool) {
+    return UmpireSpace(Impl::umpire_make_pool(
+        name_, Impl::umpire_default_allocator<upstream_memory_space>(),
+        initial_bytes_, grow_bytes_, strategy_));
+  }
+
+  /**\brief  Return a memory space allocating from the Umpire allocator of
+   *         upstream_ whose allocations (and View data) are aligned to
+   *         alignment_ bytes, e.g. a cache line, a page or a huge page.
+   *
+   *  Requests are only padded when alignment_ exceeds what the allocator
+   *  guarantees by itself.
+   */
+  static UmpireSpace make_aligned(
+      const size_t alignment_, const UmpireSpace& upstream_ = UmpireSpace()) {
+    if (!Kokkos::Impl::is_integral_power_of_two(alignment_)) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::make_aligned ERROR: alignment must be a power "
+          "of two");
+    }
+    UmpireSpace space(upstream_);
+    space.m_ThreadCache = nullptr;
+    space.m_SizeClasses = nullptr;
+    space.m_Arena       = nullptr;
+    space.m_Alignment   = alignment_;
+    return space;
+  }
+
+  /**\brief  Return a host memory space placing the pages of its
+   *         allocations on NUMA nodes according to policy_:
+   *
+   *  Interleave - round robin over all online nodes
+   *  Bind       - on node node_
+   *  FirstTouch - wherever the threads of the default host execution space
+   *               that own them under a static schedule first touch them,
+   *               which happens right at allocation
+   *
+   *  Interleave and Bind place requests of at least umpire_numa_threshold
+   *  bytes; FirstTouch touches requests of at least
+   *  umpire_first_touch_min_bytes.  Placement is best effort: on systems
+   *  without NUMA support the pages are placed by the kernel as usual.
+   */
+  static UmpireSpace make_numa(const UmpireNumaPolicy policy_,
+                               const int node_ = 0) {
+    static_assert(std::is_same<upstream_memory_space, Kokkos::HostSpace>::value,
+                  "UmpireSpace::make_numa requires UmpireHostSpace");
+    if (policy_ == UmpireNumaPolicy::FirstTouch) {
+      UmpireSpace space;
+      space.m_FirstTouch = true;
+      return space;
+    }
+    return UmpireSpace(Impl::umpire_numa_allocator(policy_, node_));
+  }
+
+  /**\brief  Return a host memory space whose allocations of at least
+   *         umpire_file_threshold bytes are memory mapped files on local
+   *         disk, so that Views larger than memory are paged in and out by
+   *         the operating system.
+   *
+   *  The files are created in options_.directory and removed right away, so
+   *  nothing is left behind; the pages are written back to them when memory
+   *  gets short.  Spaces with the same options share one Umpire allocator,
+   *  named as given by umpire_file_allocator_name.
+   */
+  static UmpireSpace make_file(
+      const UmpireFileOptions& options_ = UmpireFileOptions()) {
+    static_assert(std::is_same<upstream_memory_space, Kokkos::HostSpace>::value,
+                  "UmpireSpace::make_file requires UmpireHostSpace");
+    return UmpireSpace(Impl::get_allocator(
+        Impl::umpire_file_allocator_name(options_).c_str()));
+  }
+
+  /**\brief  Return a host memory space in POSIX shared memory, in which
+   *         each View is a segment that other processes on the node can
+   *         attach to by its label (see umpire_attach_shared in
+   *         Kokkos_UmpireSpace_Shared.hpp), e.g. to keep one copy of a
+   *         read-only table per node instead of one per MPI rank.
+   *
+   *  Segments are named "/<prefix_>.<label>:<pid>.<serial>"; of several
+   *  Views with the same label, e.g. the old and the new allocation of a
+   *  reallocated View, the newest one is attached to.  Pass e.g. a job id
+   *  as prefix_ to keep concurrent jobs apart.  A segment is removed when
+   *  its View is destroyed, processes attached to it keep their mapping.
+   */
+  static UmpireSpace make_node_shared(const char* prefix_ = nullptr) {
+    static_assert(std::is_same<upstream_memory_space, Kokkos::HostSpace>::value,
+                  "UmpireSpace::make_node_shared requires UmpireHostSpace");
+    return UmpireSpace(Impl::get_allocator(
+        Impl::umpire_shared_allocator_name(prefix_).c_str()));
+  }
+
+  /**\brief  Return a memory space whose allocations are zero, i.e. Views in
+   *         it of arithmetic types can be created WithoutInitializing.
+   *
+   *  Allocations in freshly mapped pages (of the HOST_HUGEPAGE and
+   *  HOST_HUGETLB allocators) are zero already and are not touched, all
+   *  others are zeroed with fill.
+   */
+  static UmpireSpace make_zeroed(const UmpireSpace& upstream_ = UmpireSpace()) {
+    UmpireSpace space(upstream_);
+    space.m_Zeroed = true;
+    return space;
+  }
+
+  /**\brief  Return a memory space that serves small requests (up to 4 KiB)
+   *         from per-thread free lists in front of the Umpire allocator of
+   *         upstream_, so that host threads allocating small objects
+   *         concurrently neither race on nor serialize behind the shared
+   *         allocator.
+   *
+   *  The free lists are refilled from the allocator in batches and are
+   *  shared by all spaces made from the same Umpire allocator.  Memory
+   *  handed to the cache is not returned to the allocator.  Larger requests
+   *  go to the allocator of upstream_ as before, so they are only safe to
+   *  make concurrently if that allocator is (see make_thread_safe, which
+   *  puts a thread cache in front of its lock).
+   */
+  static UmpireSpace make_thread_cache(
+      const UmpireSpace& upstream_ = UmpireSpace()) {
+    static_assert(is_host_accessible_space(),
+                  "UmpireSpace::make_thread_cache requires a host accessible "
+                  "memory space");
+    if (upstream_.m_Alignment > Impl::umpire_thread_cache_min_bytes) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::make_thread_cache ERROR: the thread cache "
+          "cannot provide the alignment of the upstream space");
+    }
+    UmpireSpace space(upstream_);
+    space.m_ThreadCache = Impl::umpire_thread_cache(space.m_Allocator);
+    return space;
+  }
+
+  /**\brief  Return a memory space that serves requests of up to
+   *         max_bytes_ (a power of two) from Umpire FixedPools, one per
+   *         power of two size class from 64 B on, and larger requests from
+   *         the Umpire allocator of upstream_.
+   *
+   *  Small Views then neither fragment the allocator of the large ones nor
+   *  pay for its search: allocation and deallocation go straight to the
+   *  pool of their size class.  The pools are shared by all spaces made
+   *  from the same Umpire allocator; memory in them is not returned to it.
+   */
+  static UmpireSpace make_size_classes(
+      const size_t max_bytes_      = Impl::umpire_size_class_default_max_bytes,
+      const UmpireSpace& upstream_ = UmpireSpace()) {
+    if (upstream_.m_Alignment > Impl::umpire_pool_alignment) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::make_size_classes ERROR: the size classes "
+          "cannot provide the alignment of the upstream space");
+    }
+    UmpireSpace space(upstream_);
+    space.m_ThreadCache = nullptr;
+    space.m_Arena       = nullptr;
+    space.m_SizeClasses =
+        Impl::umpire_size_classes(space.m_Allocator, max_bytes_);
+    space.m_SizeClassMaxBytes = max_bytes_;
+    return space;
+  }
+
+  /**\brief  Return a memory space like upstream_ whose allocate and
+   *         deallocate may be called concurrently, e.g. to create Views in
+   *         OpenMP parallel regions or HPX tasks.
+   *
+   *  The Umpire allocator of upstream_ is wrapped in an Umpire
+   *  ThreadSafeAllocator named "<allocator>::thread_safe", which serializes
+   *  its calls on a lock.  Host accessible spaces keep small requests off
+   *  that lock with a thread cache (see make_thread_cache), and the pools
+   *  of size classes (see make_size_classes) get a lock each.  Arenas lock
+   *  by themselves; make them on top of a thread safe space instead.
+   */
+  static UmpireSpace make_thread_safe(
+      const UmpireSpace& upstream_ = UmpireSpace()) {
+    if (upstream_.m_Arena) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::make_thread_safe ERROR: make the arena on top "
+          "of a thread safe space instead");
+    }
+    UmpireSpace space(Impl::umpire_make_thread_safe(upstream_.m_Allocator));
+    space.m_AllocatorAlignment = upstream_.m_AllocatorAlignment;
+    space.m_Alignment          = upstream_.m_Alignment;
+    space.m_FirstTouch         = upstream_.m_FirstTouch;
+    space.m_Zeroed             = upstream_.m_Zeroed;
+    if (upstream_.m_SizeClasses) {
+      space.m_SizeClasses = Impl::umpire_size_classes(
+          space.m_Allocator, upstream_.m_SizeClassMaxBytes);
+      space.m_SizeClassMaxBytes = upstream_.m_SizeClassMaxBytes;
+    }
+    if constexpr (is_host_accessible_space()) {
+      if (space.m_Alignment <= Impl::umpire_thread_cache_min_bytes) {
+        space.m_ThreadCache = Impl::umpire_thread_cache(space.m_Allocator);
+      }
+    }
+    return space;
+  }
+
+  /**\brief  Whether allocate and deallocate of this space may be called
+   *         concurrently (see make_thread_safe)
+   */
+  bool is_thread_safe() const {
+    return Impl::umpire_is_thread_safe(m_Allocator);
+  }
+
+  /**\brief  Return an arena memory space for temporaries: allocation bumps
+   *         a pointer into blocks of (at least) block_bytes_ taken from the
+   *         Umpire allocator of upstream_, and deallocation is a no-op.
+   *
+   *  Memory is reclaimed all at once by reset().  The arena is shared by
+   *  copies of the returned space and gives its blocks back to the
+   *  allocator when the last of them is destroyed.
+   */
+  static UmpireSpace make_arena(const size_t block_bytes_,
+                                const UmpireSpace& upstream_ = UmpireSpace()) {
+    UmpireSpace space(upstream_);
+    space.m_ThreadCache = nullptr;
+    space.m_SizeClasses = nullptr;
+    space.m_Arena       = Impl::umpire_make_arena(
+        space.m_Allocator, block_bytes_, space.m_Alignment);
+    return space;
+  }
+
+  /**\brief  Reclaim all memory of an arena space (see make_arena) at once.
+   *
+   *  Every allocation from the arena must have been deallocated, i.e. all
+   *  Views in the space destroyed, otherwise an exception is thrown.
+   */
+  void reset() const {
+    if (!m_Arena) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::reset ERROR: not an arena space");
+    }
+    Impl::umpire_arena_reset(m_Arena.get());
+  }
 
   UmpireSpace(UmpireSpace&& rhs)      = default;
   UmpireSpace(const UmpireSpace& rhs) = default;
@@ -122,16 +874,83 @@ class UmpireSpace {
 
   /**\brief  Allocate untracked memory in the space */
   inline void* allocate(const size_t arg_alloc_size) const {
-    return Impl::umpire_allocate(m_AllocatorName, arg_alloc_size);
+    void* const ptr = allocate_impl(arg_alloc_size);
+    if (ptr) {
+      const size_t padding = alignment_padding(arg_alloc_size);
+      m_Counters->allocated(arg_alloc_size + padding, padding);
+      if (Impl::umpire_trace_active.load(std::memory_order_relaxed)) {
+        Impl::umpire_trace_allocate(m_Allocator, ptr, arg_alloc_size);
+      }
+    }
+    return ptr;
   }
 
   /**\brief  Deallocate untracked memory in the space */
   inline void deallocate(void* const arg_alloc_ptr,
                          const size_t arg_alloc_size) const {
-    return Impl::umpire_deallocate(m_AllocatorName, arg_alloc_ptr,
-                                   arg_alloc_size);
+    if (arg_alloc_ptr) {
+      const size_t padding = alignment_padding(arg_alloc_size);
+      m_Counters->deallocated(arg_alloc_size + padding, padding);
+      if (Impl::umpire_trace_active.load(std::memory_order_relaxed)) {
+        Impl::umpire_trace_deallocate(m_Allocator, arg_alloc_ptr,
+                                      arg_alloc_size);
+      }
+    }
+    deallocate_impl(arg_alloc_ptr, arg_alloc_size);
+    if (Impl::UmpireReleaser* const releaser =
+            m_Counters->releaser.load(std::memory_order_acquire)) {
+      Impl::umpire_release_check(releaser);
+    }
+  }
+
+  /**\brief  Set n bytes at ptr, in memory of this space, to value.
+   *
+   *  Host accessible memory is set in parallel on the default host
+   *  execution space from umpire_parallel_copy_threshold() bytes on, other
+   *  memory with the Umpire MEMSET operation.  Returns when done.
+   */
+  static void fill(void* const ptr, const int value, const size_t n) {
+    if (n == 0) return;
+    if constexpr (is_host_accessible_space()) {
+      Impl::umpire_host_fill(ptr, value, n);
+    } else {
+      Impl::umpire_memset(ptr, value, n);
+    }
+  }
+
+  /**\brief  Allocation statistics of the Umpire allocator of this space,
+   *         gathered over all spaces allocating from it
+   */
+  UmpireSpaceStatistics statistics() const {
+    return m_Counters->statistics();
+  }
+
+  /**\brief  Release the free memory of the Umpire allocator of this space,
+   *         e.g. the unused blocks of a pool, to its upstream allocator, and
+   *         return the number of bytes released.
+   *
+   *  Pools keep growing to their peak otherwise.  Must not run while other
+   *  threads allocate from the allocator.  The blocks of thread caches and
+   *  size classes stay with them.
+   */
+  size_t release() const { return Impl::umpire_release(m_Allocator); }
+
+  /**\brief  Release the free memory of the Umpire allocator of this space
+   *         as policy_ says from now on, for all spaces allocating from it.
+   *
+   *  Thread safe spaces (see make_thread_safe) only take the release point
+   *  policy, since the others release during concurrent deallocations.
+   */
+  void set_release_policy(const UmpireReleasePolicy& policy_) const {
+    Impl::umpire_set_release_policy(m_Allocator, m_Counters, policy_);
   }
 
+  /**\brief  Alignment of the allocations (and View data) of this space */
+  size_t alignment() const { return m_Alignment; }
+
+  /**\brief  The Umpire allocator this space allocates from */
+  umpire::Allocator get_allocator() const { return m_Allocator; }
+
   /**\brief Return Name of the MemorySpace */
   static constexpr const char* name() { return m_name; }
 
@@ -142,7 +961,147 @@ class UmpireSpace {
 
  private:
   using upstream_memory_space = MemorySpace;
+
+  inline void* allocate_impl(const size_t arg_alloc_size) const {
+    if (m_Arena) {
+      return zeroed(Impl::umpire_arena_allocate(m_Arena.get(), arg_alloc_size),
+                    arg_alloc_size);
+    }
+    if (m_ThreadCache && 0 < arg_alloc_size &&
+        arg_alloc_size <= Impl::umpire_thread_cache_max_bytes) {
+      return zeroed(
+          Impl::umpire_thread_cache_allocate(m_ThreadCache, arg_alloc_size),
+          arg_alloc_size);
+    }
+    if (size_classed(arg_alloc_size)) {
+      return zeroed(
+          Impl::umpire_size_class_allocate(m_SizeClasses, arg_alloc_size),
+          arg_alloc_size);
+    }
+    void* const ptr =
+        padded(arg_alloc_size)
+            ? Impl::umpire_allocate_aligned(m_Allocator, arg_alloc_size,
+                                            m_Alignment,
+                                            is_host_accessible_space())
+            : Impl::umpire_allocate(m_Allocator, arg_alloc_size);
+    if (m_FirstTouch) Impl::umpire_first_touch(ptr, arg_alloc_size);
+    if (m_Zeroed &&
+        Impl::umpire_is_fresh_mapping(m_Allocator, ptr, arg_alloc_size)) {
+      return ptr;
+    }
+    return zeroed(ptr, arg_alloc_size);
+  }
+
+  /* zero a new allocation of a space made by make_zeroed */
+  void* zeroed(void* const ptr, const size_t arg_alloc_size) const {
+    if (m_Zeroed && ptr) fill(ptr, 0, arg_alloc_size);
+    return ptr;
+  }
+
+  inline void deallocate_impl(void* const arg_alloc_ptr,
+                              const size_t arg_alloc_size) const {
+    if (m_Arena) return Impl::umpire_arena_deallocate(m_Arena.get());
+    if (m_ThreadCache && 0 < arg_alloc_size &&
+        arg_alloc_size <= Impl::umpire_thread_cache_max_bytes) {
+      return Impl::umpire_thread_cache_deallocate(m_ThreadCache, arg_alloc_ptr,
+                                                  arg_alloc_size);
+    }
+    if (size_classed(arg_alloc_size)) {
+      return Impl::umpire_size_class_deallocate(m_SizeClasses, arg_alloc_ptr,
+                                                arg_alloc_size);
+    }
+    if (padded(arg_alloc_size)) {
+      return Impl::umpire_deallocate_aligned(m_Allocator, arg_alloc_ptr,
+                                             arg_alloc_size,
+                                             is_host_accessible_space());
+    }
+    return Impl::umpire_deallocate(m_Allocator, arg_alloc_ptr,
+                                   arg_alloc_size);
+  }
+
+  /* Resize the allocation at arg_alloc_ptr from arg_old_size to
+   * arg_new_size bytes without the caller copying its contents: an arena
+   * moves its bump pointer if the allocation is its most recent one, the
+   * plain host allocator goes through Umpire's reallocate (realloc, which
+   * remaps rather than copies large blocks).  Returns the possibly moved
+   * allocation, or nullptr if it has to be copied after all.
+   */
+  inline void* reallocate_impl(void* const arg_alloc_ptr,
+                               const size_t arg_old_size,
+                               const size_t arg_new_size) const {
+    if (m_FirstTouch) return nullptr;
+    if (m_ThreadCache &&
+        std::min(arg_old_size, arg_new_size) <=
+            Impl::umpire_thread_cache_max_bytes) {
+      return nullptr;
+    }
+    if (size_classed(std::min(arg_old_size, arg_new_size))) return nullptr;
+    void* ptr = nullptr;
+    if (m_Arena) {
+      ptr = Impl::umpire_arena_reallocate(m_Arena.get(), arg_alloc_ptr,
+                                          arg_old_size, arg_new_size);
+    } else if (padded(arg_old_size) != padded(arg_new_size)) {
+      // only one of the sizes is mapped (aligned) by the allocator
+    } else if (!padded(arg_new_size)) {
+      ptr = Impl::umpire_reallocate(m_Allocator, arg_alloc_ptr, arg_new_size);
+    } else if (is_host_accessible_space()) {
+      ptr = Impl::umpire_reallocate_aligned(m_Allocator, arg_alloc_ptr,
+                                            arg_old_size, arg_new_size,
+                                            m_Alignment);
+    }
+    if (ptr) {
+      m_Counters->resized(arg_old_size, arg_new_size);
+      if (Impl::umpire_trace_active.load(std::memory_order_relaxed)) {
+        Impl::umpire_trace_reallocate(m_Allocator, arg_alloc_ptr, ptr,
+                                      arg_old_size, arg_new_size);
+      }
+    }
+    return ptr;
+  }
+
+  /* bytes the aligned path adds to a request of arg_alloc_size */
+  size_t alignment_padding(const size_t arg_alloc_size) const {
+    const bool thread_cached =
+        m_ThreadCache && 0 < arg_alloc_size &&
+        arg_alloc_size <= Impl::umpire_thread_cache_max_bytes;
+    return !m_Arena && !thread_cached && !size_classed(arg_alloc_size) &&
+                   padded(arg_alloc_size)
+               ? m_Alignment
+               : 0;
+  }
+
+  /* whether the allocator falls short of the alignment of the space for a
+   * request of arg_alloc_size, which is then padded
+   */
+  bool padded(const size_t arg_alloc_size) const {
+    return m_Alignment > m_AllocatorAlignment.of(arg_alloc_size);
+  }
+
+  /* whether a request of arg_alloc_size goes to a size class pool */
+  bool size_classed(const size_t arg_alloc_size) const {
+    return m_SizeClasses && 0 < arg_alloc_size &&
+           arg_alloc_size <= m_SizeClassMaxBytes;
+  }
+
   const char* m_AllocatorName;
+  // resolved once at construction; allocate/deallocate go straight to it
+  mutable umpire::Allocator m_Allocator;
+  // alignment guaranteed by the allocator, and the one promised by the space
+  Impl::UmpireAllocatorAlignment m_AllocatorAlignment;
+  // allocation statistics, shared by all spaces using the allocator
+  Impl::UmpireSpaceCounters* m_Counters;
+  size_t m_Alignment = Kokkos::Impl::MEMORY_ALIGNMENT;
+  // optional per-thread front end for small allocations
+  Impl::UmpireThreadCache* m_ThreadCache = nullptr;
+  // optional fixed pools for requests of up to m_SizeClassMaxBytes
+  Impl::UmpireSizeClasses* m_SizeClasses = nullptr;
+  size_t m_SizeClassMaxBytes             = 0;
+  // optional bump allocator with bulk reset
+  std::shared_ptr<Impl::UmpireArena> m_Arena;
+  // touch new allocations from the default host execution space
+  bool m_FirstTouch = false;
+  // zero new allocations (see make_zeroed)
+  bool m_Zeroed = false;
   static constexpr const char* m_name = "Umpire";
   friend class Kokkos::Impl::SharedAllocationRecord<
       Kokkos::UmpireSpace<upstream_memory_space>, void>;
@@ -266,19 +1225,70 @@ class SharedAllocationRecord<
 #endif
 
   const MemorySpace m_space;
+  // bytes of data the allocation holds, at least size() after an in place
+  // shrink, and whether it has been handed over to another record
+  size_t m_capacity = 0;
+  bool m_released   = false;
+
+  /* whether the header of a host accessible allocation is mirrored too */
+  static bool mirror_host_header() {
+#if defined(KOKKOS_ENABLE_PROFILING)
+    return MemorySpace::is_host_accessible_space() &&
+           Kokkos::Profiling::profileLibraryLoaded();
+#else
+    return false;
+#endif
+  }
+
+  /**\brief  Padding in front of the header such that the data, rather than
+   *         the header, gets the alignment of the space.
+   */
+  static size_t header_padding(const MemorySpace& arg_space) {
+    return arg_space.alignment() > sizeof(SharedAllocationHeader)
+               ? arg_space.alignment() - sizeof(SharedAllocationHeader)
+               : 0;
+  }
+
+  static SharedAllocationHeader* allocation_with_header(
+      const MemorySpace& arg_space, const std::string& arg_label,
+      const size_t arg_alloc_size) {
+    const size_t padding = header_padding(arg_space);
+    Kokkos::Impl::UmpireNamedAllocation named(arg_label.c_str());
+    SharedAllocationHeader* const header =
+        reinterpret_cast<SharedAllocationHeader*>(
+            reinterpret_cast<char*>(
+                Kokkos::Impl::checked_allocation_with_header(
+                    arg_space, arg_label, padding + arg_alloc_size)) +
+            padding);
+    if (named.segment) {
+      Kokkos::Impl::umpire_shared_publish(named.segment, header + 1,
+                                          arg_alloc_size);
+    }
+    return header;
+  }
 
  protected:
   inline ~SharedAllocationRecord() {
 #if defined(KOKKOS_ENABLE_PROFILING)
-    if (Kokkos::Profiling::profileLibraryLoaded()) {
+    if (Kokkos::Profiling::profileLibraryLoaded() && !m_released) {
       Kokkos::Profiling::deallocateData(
-          Kokkos::Profiling::SpaceHandle(MemorySpace::name()),
-          RecordBase::m_alloc_ptr->m_label, data(), size());
+          Kokkos::Profiling::SpaceHandle(MemorySpace::name()), get_label(),
+          data(), size());
     }
 #endif
 
-    m_space.deallocate(SharedAllocationRecord<void, void>::m_alloc_ptr,
-                       SharedAllocationRecord<void, void>::m_alloc_size);
+    if (!MemorySpace::is_host_accessible_space() || mirror_host_header()) {
+      Kokkos::Impl::umpire_header_mirror_erase(RecordBase::m_alloc_ptr);
+    }
+
+    if (RecordBase::m_alloc_ptr && !m_released) {
+      const size_t padding = header_padding(m_space);
+      m_space.m_Counters->remove_overhead(padding +
+                                          sizeof(SharedAllocationHeader));
+      m_space.deallocate(
+          reinterpret_cast<char*>(RecordBase::m_alloc_ptr) - padding,
+          padding + sizeof(SharedAllocationHeader) + m_capacity);
+    }
   }
   SharedAllocationRecord() = default;
 
@@ -290,22 +1300,50 @@ class SharedAllocationRecord<
 #ifdef KOKKOS_DEBUG
             &SharedAllocationRecord<MemorySpace, void>::s_root_record,
 #endif
-            Kokkos::Impl::checked_allocation_with_header(arg_space, arg_label,
-                                                         arg_alloc_size),
+            allocation_with_header(arg_space, arg_label, arg_alloc_size),
             sizeof(SharedAllocationHeader) + arg_alloc_size, arg_dealloc),
-        m_space(arg_space) {
+        m_space(arg_space),
+        m_capacity(arg_alloc_size) {
+    m_space.m_Counters->add_overhead(header_padding(m_space) +
+                                     sizeof(SharedAllocationHeader));
+    initialize(arg_label);
+  }
+
+  /**\brief  Record taking over the allocation at arg_alloc_ptr, holding
+   *         arg_capacity bytes of data, from a record that was resized in
+   *         place (see reallocate_in_place).
+   */
+  inline SharedAllocationRecord(const MemorySpace& arg_space,
+                                const std::string& arg_label,
+                                SharedAllocationHeader* const arg_alloc_ptr,
+                                const size_t arg_alloc_size,
+                                const size_t arg_capacity)
+      : SharedAllocationRecord<void, void>(
+#ifdef KOKKOS_DEBUG
+            &SharedAllocationRecord<MemorySpace, void>::s_root_record,
+#endif
+            arg_alloc_ptr, sizeof(SharedAllocationHeader) + arg_alloc_size,
+            &deallocate),
+        m_space(arg_space),
+        m_capacity(arg_capacity) {
+    initialize(arg_label);
+  }
+
+ private:
+  /* report the allocation to Kokkos Tools and point its header at this */
+  inline void initialize(const std::string& arg_label) {
 #if defined(KOKKOS_ENABLE_PROFILING)
     if (Kokkos::Profiling::profileLibraryLoaded()) {
       Kokkos::Profiling::allocateData(
-          Kokkos::Profiling::SpaceHandle(arg_space.name()), arg_label, data(),
-          arg_alloc_size);
+          Kokkos::Profiling::SpaceHandle(m_space.name()), arg_label, data(),
+          size());
     }
 #endif
 
 #if defined(KOKKOS_ACTIVE_EXECUTION_MEMORY_SPACE_HOST)
     // is_host_accessible_space implies that header is in host space, so we
     // can access it directly
-    if (MemorySpace::is_host_accessible_space()) {
+    if constexpr (MemorySpace::is_host_accessible_space()) {
       // Fill in the Header information
       RecordBase::m_alloc_ptr->m_record =
           static_cast<SharedAllocationRecord<void, void>*>(this);
@@ -315,6 +1353,12 @@ class SharedAllocationRecord<
       // Set last element zero, in case c_str is too long
       RecordBase::m_alloc_ptr
           ->m_label[SharedAllocationHeader::maximum_label_length - 1] = (char)0;
+
+      // for the labels of deep copies reported to Kokkos Tools
+      if (mirror_host_header()) {
+        Kokkos::Impl::umpire_header_mirror_insert(RecordBase::m_alloc_ptr,
+                                                  *RecordBase::m_alloc_ptr);
+      }
     } else {
       SharedAllocationHeader header;
 
@@ -331,21 +1375,86 @@ class SharedAllocationRecord<
       Kokkos::Impl::host_to_umpire_deep_copy(RecordBase::m_alloc_ptr, &header,
                                              sizeof(SharedAllocationHeader),
                                              false);
+
+      // and keep a host side mirror for get_record / get_label
+      Kokkos::Impl::umpire_header_mirror_insert(RecordBase::m_alloc_ptr,
+                                                header);
+    }
+#endif
+  }
+
+  /* Resize the allocation of r_old to arg_alloc_size bytes without copying
+   * it, which requires that nobody else holds on to it: within its capacity
+   * unless that would leave more than half of it unused, else through the
+   * space (see UmpireSpace::reallocate_impl).  On success r_old is released
+   * and a record taking over the allocation returned, otherwise nullptr.
+   */
+  static SharedAllocationRecord* reallocate_in_place(
+      SharedAllocationRecord* const r_old, const size_t arg_alloc_size) {
+#if defined(KOKKOS_ACTIVE_EXECUTION_MEMORY_SPACE_HOST)
+    if (r_old->use_count() != 1) return nullptr;
+
+    // r_old goes away below
+    const MemorySpace space(r_old->m_space);
+    const std::string label = r_old->get_label();
+    const size_t padding    = header_padding(space);
+    const size_t head     = padding + sizeof(SharedAllocationHeader);
+    const size_t old_size = r_old->size();
+    char* alloc_ptr = reinterpret_cast<char*>(r_old->m_alloc_ptr) - padding;
+    size_t capacity = r_old->m_capacity;
+
+    if (arg_alloc_size > capacity || 2 * arg_alloc_size < capacity) {
+      alloc_ptr = static_cast<char*>(space.reallocate_impl(
+          alloc_ptr, head + capacity, head + arg_alloc_size));
+      if (alloc_ptr == nullptr) return nullptr;
+      capacity = arg_alloc_size;
+    }
+
+    // a zeroed space grows by zero bytes, whichever way the allocation
+    // grew, also over data an earlier shrink within the capacity left
+    if (space.m_Zeroed && arg_alloc_size > old_size) {
+      MemorySpace::fill(alloc_ptr + head + old_size, 0,
+                        arg_alloc_size - old_size);
+    }
+
+#if defined(KOKKOS_ENABLE_PROFILING)
+    // the header of r_old may have moved, so report it here
+    if (Kokkos::Profiling::profileLibraryLoaded()) {
+      Kokkos::Profiling::deallocateData(
+          Kokkos::Profiling::SpaceHandle(MemorySpace::name()), label,
+          r_old->data(), r_old->size());
     }
 #endif
+
+    // the old record must not free what it no longer owns
+    r_old->m_released = true;
+    RecordBase::decrement(r_old);
+
+    return new SharedAllocationRecord(
+        space, label,
+        reinterpret_cast<SharedAllocationHeader*>(alloc_ptr + padding),
+        arg_alloc_size, capacity);
+#else
+    (void)r_old;
+    (void)arg_alloc_size;
+    return nullptr;
+#endif
   }
 
  public:
   inline std::string get_label() const {
 #if defined(KOKKOS_ACTIVE_EXECUTION_MEMORY_SPACE_HOST)
-    if (MemorySpace::is_host_accessible_space()) {
+    if constexpr (MemorySpace::is_host_accessible_space()) {
       return std::string(RecordBase::head()->m_label);
     } else {
-      // we don't know where the umpire pointer lives, so it is best to create a
-      // local header, then deep copy from umpire to host and use the local.
       SharedAllocationHeader header;
-      Kokkos::Impl::umpire_to_host_deep_copy(
-          &header, RecordBase::head(), sizeof(SharedAllocationHeader), false);
+      if (!Kokkos::Impl::umpire_header_mirror_find(RecordBase::head(),
+                                                   header)) {
+        // no mirror (e.g. the root record), so deep copy the header from
+        // umpire to host and use the local.
+        Kokkos::Impl::umpire_to_host_deep_copy(
+            &header, RecordBase::head(), sizeof(SharedAllocationHeader), false);
+      }
 
       return std::string(header.m_label);
     }
@@ -382,6 +1491,13 @@ class SharedAllocationRecord<
   inline static void* reallocate_tracked(void* const arg_alloc_ptr,
                                          const size_t arg_alloc_size) {
     SharedAllocationRecord* const r_old = get_record(arg_alloc_ptr);
+
+    if (SharedAllocationRecord* const r_moved =
+            reallocate_in_place(r_old, arg_alloc_size)) {
+      RecordBase::increment(r_moved);
+      return r_moved->data();
+    }
+
     SharedAllocationRecord* const r_new =
         allocate(r_old->m_space, r_old->get_label(), arg_alloc_size);
 
@@ -407,26 +1523,26 @@ class SharedAllocationRecord<
     using Header       = SharedAllocationHeader;
     using RecordUmpire = SharedAllocationRecord;
 
-    // Copy the header from the allocation
-    // cannot determine if it is host or device statically, so we will always
-    // deep copy it....
-
 #if defined(KOKKOS_ACTIVE_EXECUTION_MEMORY_SPACE_HOST)
-    Header head;
-
     Header const* const head_dev =
         arg_alloc_ptr ? Header::get_header(arg_alloc_ptr) : (Header*)0;
 
+    RecordUmpire* record = (RecordUmpire*)0;
+
     if (arg_alloc_ptr) {
-      Kokkos::Impl::umpire_to_host_deep_copy(
-          &head, head_dev, sizeof(SharedAllocationHeader), false);
+      if constexpr (MemorySpace::is_host_accessible_space()) {
+        // the header is in host memory, read it in place
+        record = static_cast<RecordUmpire*>(head_dev->m_record);
+      } else {
+        // use the host side mirror of the header made at allocation
+        Header head;
+        if (Kokkos::Impl::umpire_header_mirror_find(head_dev, head)) {
+          record = static_cast<RecordUmpire*>(head.m_record);
+        }
+      }
     }
 
-    RecordUmpire* const record = arg_alloc_ptr
-                                     ? static_cast<RecordUmpire*>(head.m_record)
-                                     : (RecordUmpire*)0;
-
-    if (!arg_alloc_ptr || record->m_alloc_ptr != head_dev) {
+    if (!record || record->m_alloc_ptr != head_dev) {
       Kokkos::Impl::throw_runtime_exception(std::string(
           "Kokkos::Impl::SharedAllocationRecord< Kokkos::UmpireSpace , "
           "void >::get_record ERROR"));
@@ -438,7 +1554,7 @@ class SharedAllocationRecord<
   }
 
 #ifdef KOKKOS_DEBUG
-  inline static void print_records(std::ostream&, const MemorySpace& s,
+  inline static void print_records(std::ostream& s, const MemorySpace&,
                                    bool detail = false) {
     SharedAllocationRecord<void, void>::print_host_accessible_records(
         s, "UmpireSpace", &s_root_record, detail);
@@ -465,26 +1581,22 @@ namespace Impl {
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::UmpireHostSpace, Kokkos::HostSpace, ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
-    host_to_umpire_deep_copy(dst, src, n);
+    host_accessible_deep_copy<true, false>(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    host_to_umpire_deep_copy(dst, src, n);
-    exec.fence();
+    host_accessible_deep_copy<true, false>(exec, dst, src, n);
   }
 };
 
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::HostSpace, Kokkos::UmpireHostSpace, ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
-    umpire_to_host_deep_copy(dst, src, n);
+    host_accessible_deep_copy<false, true>(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    umpire_to_host_deep_copy(dst, src, n);
-    exec.fence();
+    host_accessible_deep_copy<false, true>(exec, dst, src, n);
   }
 };
 
@@ -492,39 +1604,47 @@ template <class ExecutionSpace>
 struct DeepCopy<Kokkos::UmpireHostSpace, Kokkos::UmpireHostSpace,
                 ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
-    umpire_to_umpire_deep_copy(dst, src, n);
+    host_accessible_deep_copy<true, true>(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    umpire_to_umpire_deep_copy(dst, src, n);
-    exec.fence();
+    host_accessible_deep_copy<true, true>(exec, dst, src, n);
   }
 };
 
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::UmpireCudaSpace, Kokkos::HostSpace, ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
+    UmpireDeepCopyProfile profile(dst, true, src, false, n);
     host_to_umpire_deep_copy(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    host_to_umpire_deep_copy(dst, src, n);
-    exec.fence();
+#ifdef KOKKOS_DEBUG
+    umpire_check_copy_bounds(dst, n);
+#endif
+    UmpireDeepCopyProfile profile(dst, true, src, false, n);
+    // stream ordered on exec, as for the underlying Kokkos memory space
+    DeepCopy<Kokkos::CudaSpace, Kokkos::HostSpace, ExecutionSpace>(exec, dst,
+                                                                   src, n);
   }
 };
 
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::HostSpace, Kokkos::UmpireCudaSpace, ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
+    UmpireDeepCopyProfile profile(dst, false, src, true, n);
     umpire_to_host_deep_copy(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    umpire_to_host_deep_copy(dst, src, n);
-    exec.fence();
+#ifdef KOKKOS_DEBUG
+    umpire_check_copy_bounds(src, n);
+#endif
+    UmpireDeepCopyProfile profile(dst, false, src, true, n);
+    // stream ordered on exec, as for the underlying Kokkos memory space
+    DeepCopy<Kokkos::HostSpace, Kokkos::CudaSpace, ExecutionSpace>(exec, dst,
+                                                                   src, n);
   }
 };
 
@@ -532,13 +1652,19 @@ template <class ExecutionSpace>
 struct DeepCopy<Kokkos::UmpireCudaSpace, Kokkos::UmpireCudaSpace,
                 ExecutionSpace> {
   DeepCopy(void* dst, const void* src, size_t n) {
+    UmpireDeepCopyProfile profile(dst, true, src, true, n);
     umpire_to_umpire_deep_copy(dst, src, n);
   }
 
   DeepCopy(const ExecutionSpace& exec, void* dst, const void* src, size_t n) {
-    exec.fence();
-    umpire_to_umpire_deep_copy(dst, src, n);
-    exec.fence();
+#ifdef KOKKOS_DEBUG
+    umpire_check_copy_bounds(dst, n);
+    umpire_check_copy_bounds(src, n);
+#endif
+    UmpireDeepCopyProfile profile(dst, true, src, true, n);
+    // stream ordered on exec, as for the underlying Kokkos memory space
+    DeepCopy<Kokkos::CudaSpace, Kokkos::CudaSpace, ExecutionSpace>(exec, dst,
+                                                                   src, n);
   }
 };
 }  // namespace Impl
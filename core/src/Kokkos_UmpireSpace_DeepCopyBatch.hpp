@@ -0,0 +1,211 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOS_UMPIRESPACE_DEEPCOPYBATCH_HPP
+#define KOKKOS_UMPIRESPACE_DEEPCOPYBATCH_HPP
+
+#include <functional>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+namespace Kokkos {
+
+namespace Impl {
+
+struct UmpireCopySegment {
+  void* dst;
+  const void* src;
+  size_t bytes;
+  bool dst_is_umpire;
+  bool src_is_umpire;
+};
+
+void umpire_host_deep_copy_batch_async(
+    const Kokkos::DefaultHostExecutionSpace& exec,
+    const std::vector<UmpireCopySegment>& segments);
+
+}  // namespace Impl
+
+namespace Experimental {
+
+/**\brief  One copy of a deep_copy_batch, from the View src to the View dst.
+ *
+ *  Copies between host accessible spaces of Views with the same layout and
+ *  extents are gathered into a single kernel by deep_copy_batch, any other
+ *  copy is done by Kokkos::deep_copy on the execution space of the batch.
+ */
+template <class ExecutionSpace>
+class DeepCopyBatchEntry {
+ public:
+  template <class DstType, class SrcType>
+  DeepCopyBatchEntry(const DstType& dst, const SrcType& src) {
+    static_assert(Kokkos::is_view<DstType>::value &&
+                      Kokkos::is_view<SrcType>::value,
+                  "Kokkos::Experimental::deep_copy_batch requires Views");
+    static_assert(
+        std::is_same<typename DstType::value_type,
+                     typename DstType::non_const_value_type>::value,
+        "Kokkos::Experimental::deep_copy_batch requires non-const "
+        "destination Views");
+
+    using dst_space = typename DstType::memory_space;
+    using src_space = typename SrcType::memory_space;
+    constexpr bool host_accessible =
+        Kokkos::Impl::MemorySpaceAccess<Kokkos::HostSpace,
+                                        dst_space>::accessible &&
+        Kokkos::Impl::MemorySpaceAccess<Kokkos::HostSpace,
+                                        src_space>::accessible;
+
+    if (host_accessible && same_shape(dst, src)) {
+      m_segment = {dst.data(), src.data(),
+                   dst.span() * sizeof(typename DstType::value_type),
+                   Kokkos::Impl::is_umpire_space<dst_space>::value,
+                   Kokkos::Impl::is_umpire_space<src_space>::value};
+#ifdef KOKKOS_DEBUG
+      if (Kokkos::Impl::is_umpire_space<dst_space>::value) {
+        Kokkos::Impl::umpire_check_copy_bounds(dst.data(), m_segment.bytes);
+      }
+      if (Kokkos::Impl::is_umpire_space<src_space>::value) {
+        Kokkos::Impl::umpire_check_copy_bounds(src.data(), m_segment.bytes);
+      }
+#endif
+    } else {
+      m_fallback = [dst, src](const ExecutionSpace& exec) {
+        Kokkos::deep_copy(exec, dst, src);
+      };
+    }
+  }
+
+ private:
+  template <class DstType, class SrcType>
+  static bool same_shape(const DstType& dst, const SrcType& src) {
+    if (!std::is_same<typename DstType::non_const_value_type,
+                      typename SrcType::non_const_value_type>::value ||
+        !std::is_same<typename DstType::array_layout,
+                      typename SrcType::array_layout>::value ||
+        unsigned(DstType::rank) != unsigned(SrcType::rank) ||
+        !dst.span_is_contiguous() || !src.span_is_contiguous()) {
+      return false;
+    }
+    for (unsigned r = 0; r < DstType::rank; r++) {
+      if (dst.extent(r) != src.extent(r)) return false;
+    }
+    return true;
+  }
+
+  Kokkos::Impl::UmpireCopySegment m_segment{nullptr, nullptr, 0, false,
+                                             false};
+  std::function<void(const ExecutionSpace&)> m_fallback;
+
+  template <class ExecSpace, class Iterator>
+  friend void deep_copy_batch(const ExecSpace&, Iterator, Iterator);
+};
+
+/**\brief  Copy each src View of [begin, end) to its dst View, ordered after
+ *         the work submitted to exec.
+ *
+ *  The host accessible copies run together as one kernel (large ones
+ *  chunked over the threads) when exec is an instance of the default host
+ *  execution space, and after a single fence of exec otherwise.  The copies
+ *  of a batch may run in any order with respect to each other, and the
+ *  Views have to stay alive until exec has been fenced.  Every copy is
+ *  reported to Kokkos Tools and the allocation trace as a deep copy of its
+ *  own.
+ */
+template <class ExecutionSpace, class Iterator>
+void deep_copy_batch(const ExecutionSpace& exec, Iterator begin,
+                     Iterator end) {
+  std::vector<Kokkos::Impl::UmpireCopySegment> segments;
+  for (Iterator it = begin; it != end; ++it) {
+    if (it->m_fallback) {
+      it->m_fallback(exec);
+    } else if (it->m_segment.bytes > 0) {
+      segments.push_back(it->m_segment);
+    }
+  }
+  if (segments.empty()) return;
+
+  if constexpr (std::is_same<ExecutionSpace,
+                             Kokkos::DefaultHostExecutionSpace>::value) {
+    Kokkos::Impl::umpire_host_deep_copy_batch_async(exec, segments);
+  } else {
+    exec.fence();
+    Kokkos::DefaultHostExecutionSpace host_exec;
+    Kokkos::Impl::umpire_host_deep_copy_batch_async(host_exec, segments);
+    host_exec.fence();
+  }
+}
+
+template <class ExecutionSpace>
+void deep_copy_batch(
+    const ExecutionSpace& exec,
+    std::initializer_list<DeepCopyBatchEntry<ExecutionSpace>> copies) {
+  deep_copy_batch(exec, copies.begin(), copies.end());
+}
+
+template <class ExecutionSpace>
+void deep_copy_batch(
+    const ExecutionSpace& exec,
+    const std::vector<DeepCopyBatchEntry<ExecutionSpace>>& copies) {
+  deep_copy_batch(exec, copies.begin(), copies.end());
+}
+
+/**\brief  Synchronous deep_copy_batch: fences once before and once after
+ *         all copies.
+ */
+inline void deep_copy_batch(
+    std::initializer_list<DeepCopyBatchEntry<Kokkos::DefaultHostExecutionSpace>>
+        copies) {
+  Kokkos::fence();
+  deep_copy_batch(Kokkos::DefaultHostExecutionSpace(), copies);
+  Kokkos::fence();
+}
+
+}  // namespace Experimental
+}  // namespace Kokkos
+
+#endif  // KOKKOS_UMPIRESPACE_DEEPCOPYBATCH_HPP
@@ -0,0 +1,107 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOS_UMPIRESPACE_FILL_HPP
+#define KOKKOS_UMPIRESPACE_FILL_HPP
+
+#include <cstring>
+#include <type_traits>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+namespace Kokkos {
+
+namespace Experimental {
+
+/**\brief  Set every element of the View v in an UmpireSpace to value.
+ *
+ *  If v is contiguous and all bytes of value are the same (e.g. zero, or -1
+ *  for integers) this is a single UmpireSpace::fill of its span, a parallel
+ *  memset on the host and the Umpire MEMSET operation otherwise.  Any other
+ *  View or value goes through Kokkos::deep_copy.  Returns when done.
+ */
+template <class DT, class... DP>
+void umpire_fill(
+    const View<DT, DP...>& v,
+    const typename View<DT, DP...>::non_const_value_type& value) {
+  using view_type    = View<DT, DP...>;
+  using memory_space = typename view_type::memory_space;
+  using value_type   = typename view_type::non_const_value_type;
+  static_assert(Kokkos::Impl::is_umpire_space<memory_space>::value,
+                "Kokkos::Experimental::umpire_fill requires a View in an "
+                "UmpireSpace");
+
+  if constexpr (std::is_trivially_copyable<value_type>::value) {
+    unsigned char bytes[sizeof(value_type)];
+    std::memcpy(bytes, &value, sizeof(value_type));
+    bool uniform = true;
+    for (size_t i = 1; i < sizeof(value_type); i++) {
+      uniform = uniform && bytes[i] == bytes[0];
+    }
+    if (uniform && v.span_is_contiguous()) {
+      Kokkos::fence();
+      memory_space::fill(v.data(), bytes[0], v.span() * sizeof(value_type));
+      return;
+    }
+  }
+  Kokkos::deep_copy(v, value);
+}
+
+/**\brief  Set all bytes of the View v in an UmpireSpace to zero, which is
+ *         value zero for arithmetic types (see umpire_fill).
+ */
+template <class DT, class... DP>
+void umpire_zero(const View<DT, DP...>& v) {
+  using value_type = typename View<DT, DP...>::non_const_value_type;
+  static_assert(std::is_trivially_copyable<value_type>::value,
+                "Kokkos::Experimental::umpire_zero requires a trivially "
+                "copyable value type");
+  value_type zero;
+  std::memset(static_cast<void*>(&zero), 0, sizeof(value_type));
+  umpire_fill(v, zero);
+}
+
+}  // namespace Experimental
+}  // namespace Kokkos
+
+#endif  // KOKKOS_UMPIRESPACE_FILL_HPP
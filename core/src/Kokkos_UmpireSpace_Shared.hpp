@@ -0,0 +1,102 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+#ifndef KOKKOS_UMPIRESPACE_SHARED_HPP
+#define KOKKOS_UMPIRESPACE_SHARED_HPP
+
+#include <string>
+#include <type_traits>
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+namespace Kokkos {
+
+namespace Experimental {
+
+/**\brief  Attach to the newest View labeled label that a process on this
+ *         node created in the node shared memory space shared (see
+ *         UmpireSpace::make_node_shared), as the unmanaged View type
+ *         ViewType with extents args.
+ *
+ *  Views of const data are mapped read only.  Throws if there is no such
+ *  View or it is smaller than the extents.  The attached View stays valid,
+ *  even after the creating process has destroyed its View, until it is
+ *  passed to umpire_detach_shared.
+ */
+template <class ViewType, class... Args>
+ViewType umpire_attach_shared(const Kokkos::UmpireHostSpace& shared,
+                              const std::string& label, const Args... args) {
+  static_assert(Kokkos::is_view<ViewType>::value &&
+                    !ViewType::traits::is_managed,
+                "Kokkos::Experimental::umpire_attach_shared requires an "
+                "unmanaged View type");
+  static_assert(Kokkos::Impl::MemorySpaceAccess<
+                    Kokkos::HostSpace,
+                    typename ViewType::memory_space>::accessible,
+                "Kokkos::Experimental::umpire_attach_shared requires a host "
+                "accessible View type");
+
+  size_t bytes = 0;
+  void* const data = Kokkos::Impl::umpire_shared_attach(
+      shared.get_allocator(), label.c_str(),
+      std::is_const<typename ViewType::value_type>::value, bytes);
+  if (ViewType::required_allocation_size(args...) > bytes) {
+    Kokkos::Impl::umpire_shared_detach(data);
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::Experimental::umpire_attach_shared ERROR: the shared View " +
+        label + " is smaller than the requested extents");
+  }
+  return ViewType(static_cast<typename ViewType::pointer_type>(data),
+                  args...);
+}
+
+/**\brief  Unmap a View attached by umpire_attach_shared */
+template <class ViewType>
+void umpire_detach_shared(const ViewType& v) {
+  Kokkos::Impl::umpire_shared_detach(v.data());
+}
+
+}  // namespace Experimental
+}  // namespace Kokkos
+
+#endif  // KOKKOS_UMPIRESPACE_SHARED_HPP
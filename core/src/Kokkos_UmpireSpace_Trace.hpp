@@ -0,0 +1,180 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOS_UMPIRESPACE_TRACE_HPP
+#define KOKKOS_UMPIRESPACE_TRACE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Kokkos {
+
+namespace Experimental {
+
+/**\brief  Start writing a binary trace of every UmpireSpace allocate,
+ *         deallocate, reallocate and deep copy, with the View label, size,
+ *         thread and time of each, to file_name.
+ *
+ *  Also started by umpire_prewarm when the environment variable
+ *  KOKKOS_UMPIRE_TRACE names a file; that trace stops at finalize.  The
+ *  trace can be replayed against other allocators with
+ *  KokkosCore_UmpireReplay.
+ */
+void umpire_trace_start(const std::string& file_name);
+
+/**\brief  Stop the trace and write out what the threads have buffered.
+ *         Other threads must not use UmpireSpaces meanwhile.
+ */
+void umpire_trace_stop();
+
+/// Kinds of the records of an UmpireSpace trace
+enum class UmpireTraceKind : uint8_t {
+  Name,
+  Allocate,
+  Deallocate,
+  Reallocate,
+  Copy
+};
+
+/// An UmpireSpace trace file is an UmpireTraceFileHeader followed by
+/// UmpireTraceRecords, in host byte order.  Each Name record gives the name
+/// of a View label or Umpire allocator id and is followed by its bytes.
+/// Records are buffered per thread, so they are only ordered by time within
+/// a thread; names always come before their first use.
+struct UmpireTraceRecord {
+  UmpireTraceKind kind;
+  uint8_t reserved[3];
+  //! thread index, in the order the threads first traced
+  uint32_t thread;
+  //! name id of the View label, 0 for none (e.g. raw allocations)
+  uint32_t label;
+  //! name id of the Umpire allocator, 0 for copies
+  uint32_t allocator;
+  //! nanoseconds since the trace started
+  uint64_t time_ns;
+  //! the allocation (Reallocate: the old one, Copy: the destination)
+  uint64_t ptr;
+  //! Reallocate: the new allocation, Copy: the source
+  uint64_t other_ptr;
+  //! bytes (Reallocate: the new size, Name: the length of the name)
+  uint64_t bytes;
+  //! Reallocate: the old size
+  uint64_t old_bytes;
+};
+
+struct UmpireTraceFileHeader {
+  char magic[8]         = {'K', 'K', 'U', 'M', 'P', 'T', 'R', 'C'};
+  uint32_t version      = 1;
+  uint32_t record_bytes = sizeof(UmpireTraceRecord);
+};
+
+/// An UmpireSpace trace as read back by umpire_read_trace
+struct UmpireTrace {
+  //! names by id, names[0] is empty
+  std::vector<std::string> names{std::string()};
+  //! all but the Name records, in file order
+  std::vector<UmpireTraceRecord> records;
+};
+
+/**\brief  Read the trace file file_name, returning false if it is not one.
+ *
+ *  Truncated or corrupted traces are rejected as well: records of unknown
+ *  kinds, names running past the end of the file, name ids that were not
+ *  given out (they are dense from 1 on) and records using them.
+ */
+inline bool umpire_read_trace(const std::string& file_name,
+                              UmpireTrace& trace) {
+  std::ifstream in(file_name, std::ios::binary | std::ios::ate);
+  if (!in) return false;
+  const uint64_t file_bytes = static_cast<uint64_t>(in.tellg());
+  in.seekg(0);
+
+  UmpireTraceFileHeader header;
+  const UmpireTraceFileHeader expected;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      std::memcmp(header.magic, expected.magic, sizeof(header.magic)) ||
+      header.version != expected.version ||
+      header.record_bytes != expected.record_bytes) {
+    return false;
+  }
+
+  trace = UmpireTrace();
+  std::vector<std::pair<uint32_t, std::string>> names;
+  UmpireTraceRecord record;
+  while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+    if (record.kind > UmpireTraceKind::Copy) return false;
+    if (record.kind != UmpireTraceKind::Name) {
+      trace.records.push_back(record);
+      continue;
+    }
+    if (record.bytes > file_bytes - static_cast<uint64_t>(in.tellg())) {
+      return false;
+    }
+    std::string name(record.bytes, '\0');
+    if (!in.read(&name[0], name.size())) return false;
+    names.emplace_back(record.label, std::move(name));
+  }
+  // a partial record at the end
+  if (!in.eof() || in.gcount() != 0) return false;
+
+  trace.names.resize(names.size() + 1);
+  for (auto& name : names) {
+    if (name.first == 0 || name.first > names.size()) return false;
+    trace.names[name.first] = std::move(name.second);
+  }
+  for (const auto& r : trace.records) {
+    if (r.label >= trace.names.size() || r.allocator >= trace.names.size()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace Experimental
+}  // namespace Kokkos
+
+#endif  // KOKKOS_UMPIRESPACE_TRACE_HPP
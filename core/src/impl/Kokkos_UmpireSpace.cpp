@@ -60,16 +60,214 @@
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <Kokkos_UmpireSpace.hpp>
 #include <impl/Kokkos_Error.hpp>
 #include <Kokkos_Atomic.hpp>
 
 #include "umpire/op/MemoryOperationRegistry.hpp"
+#include "umpire/strategy/QuickPool.hpp"
+#include "umpire/strategy/DynamicPoolList.hpp"
+#include "umpire/strategy/ThreadSafeAllocator.hpp"
+
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
 
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
+namespace {
+
+/* UmpireOperationCache - memoized MemoryOperationRegistry lookups.
+ *
+ * The registry resolves an operation by name and by the platforms of the two
+ * strategies on every call, while a code typically copies between the same
+ * few pairs of spaces over and over.  Resolved operations are kept in a small
+ * open addressed table keyed by (operation, source strategy, destination
+ * strategy).  Slots are only ever filled, never cleared: they are written
+ * under a mutex and published with a release store of the operation pointer,
+ * so readers probe the table without taking a lock.  The registry owns the
+ * operations for the lifetime of the process, so raw pointers are safe to
+ * hand out.
+ */
+class UmpireOperationCache {
+ public:
+  enum OperationKind { COPY = 0, MEMSET = 1 };
+
+  umpire::op::MemoryOperation *find(OperationKind kind,
+                                    umpire::strategy::AllocationStrategy *src,
+                                    umpire::strategy::AllocationStrategy *dst) {
+    const std::size_t start = hash(kind, src, dst);
+    for (std::size_t i = 0; i < capacity; ++i) {
+      Entry &entry = m_entries[(start + i) & (capacity - 1)];
+      umpire::op::MemoryOperation *op =
+          entry.op.load(std::memory_order_acquire);
+      if (op == nullptr) break;
+      if (entry.kind == kind && entry.src == src && entry.dst == dst) {
+        return op;
+      }
+    }
+    return insert(kind, src, dst);
+  }
+
+ private:
+  enum : std::size_t { capacity = 64 };
+
+  struct Entry {
+    std::atomic<umpire::op::MemoryOperation *> op{nullptr};
+    OperationKind kind{COPY};
+    umpire::strategy::AllocationStrategy *src{nullptr};
+    umpire::strategy::AllocationStrategy *dst{nullptr};
+  };
+
+  static std::size_t hash(OperationKind kind,
+                          umpire::strategy::AllocationStrategy *src,
+                          umpire::strategy::AllocationStrategy *dst) {
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(src) >> 4;
+    const std::uintptr_t b = reinterpret_cast<std::uintptr_t>(dst) >> 4;
+    return static_cast<std::size_t>(a * 31 + b * 17 + kind);
+  }
+
+  umpire::op::MemoryOperation *insert(
+      OperationKind kind, umpire::strategy::AllocationStrategy *src,
+      umpire::strategy::AllocationStrategy *dst) {
+    auto &op_registry = umpire::op::MemoryOperationRegistry::getInstance();
+    umpire::op::MemoryOperation *op =
+        op_registry.find(kind == COPY ? "COPY" : "MEMSET", src, dst).get();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t start = hash(kind, src, dst);
+    for (std::size_t i = 0; i < capacity; ++i) {
+      Entry &entry = m_entries[(start + i) & (capacity - 1)];
+      if (entry.op.load(std::memory_order_relaxed) == nullptr) {
+        entry.kind = kind;
+        entry.src  = src;
+        entry.dst  = dst;
+        entry.op.store(op, std::memory_order_release);
+        break;
+      }
+      // another thread got here first
+      if (entry.kind == kind && entry.src == src && entry.dst == dst) break;
+    }
+    // a full table just means this pair is resolved through the registry
+    return op;
+  }
+
+  Entry m_entries[capacity];
+  std::mutex m_mutex;
+};
+
+UmpireOperationCache &umpire_operation_cache() {
+  static UmpireOperationCache s_cache;
+  return s_cache;
+}
+
+/* UmpireAlignedHostStrategy - host allocation strategy behind the
+ * HOST_ALIGNED allocator: malloc'ed memory aligned to alignment by
+ * posix_memalign, so that UmpireHostSpaces never pad requests for the
+ * default alignment.  reallocate keeps what realloc offers (growth in place,
+ * remapping of large blocks) and only moves a block realloc returns
+ * misaligned.
+ */
+class UmpireAlignedHostStrategy : public umpire::strategy::AllocationStrategy {
+ public:
+  UmpireAlignedHostStrategy(const std::string &name, int id,
+                            std::size_t alignment)
+      : umpire::strategy::AllocationStrategy(name, id),
+        m_alignment(alignment) {}
+
+  void *allocate(std::size_t bytes) override {
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, m_alignment, bytes ? bytes : 1)) return nullptr;
+    return ptr;
+  }
+
+  void deallocate(void *ptr) override { free(ptr); }
+
+  umpire::Platform getPlatform() noexcept override {
+    return umpire::Platform::host;
+  }
+
+  std::size_t alignment() const { return m_alignment; }
+
+  /**\brief  Resize the block at ptr to bytes, nullptr (with the block
+   *         untouched) on failure.
+   *
+   *  realloc only aligns like malloc, and a block it has moved cannot be
+   *  moved back, so the aligned block a misaligned result is copied to is
+   *  allocated up front: the result is always aligned, and a failure leaves
+   *  the block at ptr intact.
+   */
+  void *reallocate(void *ptr, std::size_t bytes) {
+    void *const spare = allocate(bytes);
+    if (spare == nullptr) return nullptr;
+    void *const moved = realloc(ptr, bytes);
+    if (moved == nullptr ||
+        reinterpret_cast<std::uintptr_t>(moved) % m_alignment == 0) {
+      free(spare);
+      return moved;
+    }
+    std::memcpy(spare, moved, bytes);
+    free(moved);
+    return spare;
+  }
+
+ private:
+  const std::size_t m_alignment;
+};
+
+/* UmpirePools - the ids of the pools umpire_make_pool created, whose
+ * blocks are aligned to umpire_pool_alignment.  Allocators that merely share
+ * the name of a pool keep their own alignment.
+ */
+struct UmpirePools {
+  std::mutex mutex;
+  std::unordered_set<int> ids;
+
+  void add(const int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ids.insert(id);
+  }
+
+  bool contains(const int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return ids.count(id) != 0;
+  }
+};
+
+UmpirePools &umpire_pools() {
+  static UmpirePools s_pools;
+  return s_pools;
+}
+
+/* alignment strategy guarantees for every request */
+std::size_t umpire_strategy_alignment(
+    umpire::strategy::AllocationStrategy *strategy) {
+  if (auto *const aligned =
+          dynamic_cast<UmpireAlignedHostStrategy *>(strategy)) {
+    return aligned->alignment();
+  }
+  if (umpire_pools().contains(strategy->getId())) {
+    return Kokkos::Impl::umpire_pool_alignment;
+  }
+  if (strategy->getPlatform() != umpire::Platform::host) return 256;
+  return alignof(std::max_align_t);
+}
+
+/* The "HOST" strategy stands in for Kokkos host allocations, which Umpire
+ * knows nothing about, when looking up an operation.  Resolve it once.
+ */
+umpire::strategy::AllocationStrategy *umpire_host_strategy() {
+  static umpire::strategy::AllocationStrategy *const s_strategy =
+      Kokkos::Impl::get_allocator("HOST").getAllocationStrategy();
+  return s_strategy;
+}
+
+}  // namespace
+
 namespace Kokkos {
 
 namespace Impl {
@@ -87,8 +285,7 @@ namespace Impl {
  */
 void umpire_to_umpire_deep_copy(void *dst, const void *src, size_t size,
                                 bool offset) {
-  auto &rm          = umpire::ResourceManager::getInstance();
-  auto &op_registry = umpire::op::MemoryOperationRegistry::getInstance();
+  auto &rm = umpire::ResourceManager::getInstance();
 
   Kokkos::Impl::SharedAllocationHeader *dst_header =
       (Kokkos::Impl::SharedAllocationHeader *)dst;
@@ -137,8 +334,9 @@ void umpire_to_umpire_deep_copy(void *dst, const void *src, size_t size,
                  << size << " -> " << dst_size);
   }
 
-  auto op = op_registry.find("COPY", src_alloc_record->strategy,
-                             dst_alloc_record->strategy);
+  auto op = umpire_operation_cache().find(UmpireOperationCache::COPY,
+                                          src_alloc_record->strategy,
+                                          dst_alloc_record->strategy);
 
   op->transform(const_cast<void *>(src), &dst,
                 const_cast<umpire::util::AllocationRecord *>(src_alloc_record),
@@ -152,9 +350,7 @@ void umpire_to_umpire_deep_copy(void *dst, const void *src, size_t size,
  */
 void host_to_umpire_deep_copy(void *dst, const void *src, size_t size,
                               bool offset) {
-  auto &rm           = umpire::ResourceManager::getInstance();
-  auto &op_registry  = umpire::op::MemoryOperationRegistry::getInstance();
-  auto hostAllocator = rm.getAllocator("HOST");
+  auto &rm = umpire::ResourceManager::getInstance();
 
   Kokkos::Impl::SharedAllocationHeader *dst_header =
       (Kokkos::Impl::SharedAllocationHeader *)dst;
@@ -176,11 +372,12 @@ void host_to_umpire_deep_copy(void *dst, const void *src, size_t size,
 
   // Have to create a "fake" host allocator strategy to get the correct
   // Operation object
-  umpire::util::AllocationRecord src_alloc_record{
-      nullptr, size, hostAllocator.getAllocationStrategy()};
+  umpire::util::AllocationRecord src_alloc_record{nullptr, size,
+                                                  umpire_host_strategy()};
 
-  auto op = op_registry.find("COPY", src_alloc_record.strategy,
-                             dst_alloc_record->strategy);
+  auto op = umpire_operation_cache().find(UmpireOperationCache::COPY,
+                                          src_alloc_record.strategy,
+                                          dst_alloc_record->strategy);
 
   op->transform(const_cast<void *>(src), &dst,
                 const_cast<umpire::util::AllocationRecord *>(&src_alloc_record),
@@ -194,9 +391,7 @@ void host_to_umpire_deep_copy(void *dst, const void *src, size_t size,
  */
 void umpire_to_host_deep_copy(void *dst, const void *src, size_t size,
                               bool offset) {
-  auto &rm           = umpire::ResourceManager::getInstance();
-  auto &op_registry  = umpire::op::MemoryOperationRegistry::getInstance();
-  auto hostAllocator = rm.getAllocator("HOST");
+  auto &rm = umpire::ResourceManager::getInstance();
 
   Kokkos::Impl::SharedAllocationHeader *src_header =
       (Kokkos::Impl::SharedAllocationHeader *)src;
@@ -218,11 +413,12 @@ void umpire_to_host_deep_copy(void *dst, const void *src, size_t size,
 
   // Have to create a "fake" host allocator strategy to get the correct
   // Operation object
-  umpire::util::AllocationRecord dst_alloc_record{
-      nullptr, size, hostAllocator.getAllocationStrategy()};
+  umpire::util::AllocationRecord dst_alloc_record{nullptr, size,
+                                                  umpire_host_strategy()};
 
-  auto op = op_registry.find("COPY", src_alloc_record->strategy,
-                             dst_alloc_record.strategy);
+  auto op = umpire_operation_cache().find(UmpireOperationCache::COPY,
+                                          src_alloc_record->strategy,
+                                          dst_alloc_record.strategy);
 
   op->transform(const_cast<void *>(src), &dst,
                 const_cast<umpire::util::AllocationRecord *>(src_alloc_record),
@@ -230,29 +426,220 @@ void umpire_to_host_deep_copy(void *dst, const void *src, size_t size,
                 size);
 }
 
+/* umpire_check_copy_bounds - throw if a copy of size bytes starting at ptr
+ * would run past the end of the Umpire allocation holding ptr.  Pointers
+ * that Umpire does not know about (e.g. an unmanaged View assigned from
+ * HostSpace memory) are not checked.
+ */
+void umpire_check_copy_bounds(const void *ptr, size_t size) {
+  auto &rm = umpire::ResourceManager::getInstance();
+
+  if (!rm.hasAllocator(const_cast<void *>(ptr))) return;
+
+  auto alloc_record = rm.findAllocationRecord(const_cast<void *>(ptr));
+  std::ptrdiff_t alloc_offset = reinterpret_cast<const char *>(ptr) -
+                                reinterpret_cast<char *>(alloc_record->ptr);
+
+  if (alloc_offset + size > alloc_record->size) {
+    UMPIRE_ERROR("Copy runs past the end of the allocation: "
+                 << size << " -> " << alloc_record->size - alloc_offset);
+  }
+}
+
+namespace {
+
+/* UmpireHeaderMirrors - the header mirrors, sharded by header address so
+ * that threads allocating, freeing and looking up records of different
+ * allocations rarely meet on a lock.
+ */
+class UmpireHeaderMirrors {
+ public:
+  void insert(const SharedAllocationHeader *header_ptr,
+              const SharedAllocationHeader &header) {
+    Shard &shard = shard_of(header_ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.headers[header_ptr] = header;
+  }
+
+  void erase(const SharedAllocationHeader *header_ptr) {
+    Shard &shard = shard_of(header_ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.headers.erase(header_ptr);
+  }
+
+  bool find(const SharedAllocationHeader *header_ptr,
+            SharedAllocationHeader &header) {
+    Shard &shard = shard_of(header_ptr);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.headers.find(header_ptr);
+    if (it == shard.headers.end()) return false;
+    header = it->second;
+    return true;
+  }
+
+ private:
+  static constexpr int shard_bits = 6;
+
+  struct alignas(64) Shard {
+    std::mutex mutex;
+    std::unordered_map<const SharedAllocationHeader *, SharedAllocationHeader>
+        headers;
+  };
+
+  // Fibonacci hashing: headers are aligned to powers of two, so their low
+  // bits alone would put most of them in a few shards
+  Shard &shard_of(const SharedAllocationHeader *header_ptr) {
+    const uint64_t h = reinterpret_cast<uintptr_t>(header_ptr);
+    return m_shards[(h * 0x9E3779B97F4A7C15ull) >> (64 - shard_bits)];
+  }
+
+  Shard m_shards[1 << shard_bits];
+};
+
+UmpireHeaderMirrors &umpire_header_mirrors() {
+  static UmpireHeaderMirrors s_mirrors;
+  return s_mirrors;
+}
+
+}  // namespace
+
+void umpire_header_mirror_insert(const SharedAllocationHeader *header_ptr,
+                                 const SharedAllocationHeader &header) {
+  umpire_header_mirrors().insert(header_ptr, header);
+}
+
+void umpire_header_mirror_erase(const SharedAllocationHeader *header_ptr) {
+  umpire_header_mirrors().erase(header_ptr);
+}
+
+bool umpire_header_mirror_find(const SharedAllocationHeader *header_ptr,
+                               SharedAllocationHeader &header) {
+  return umpire_header_mirrors().find(header_ptr, header);
+}
+
+umpire::Allocator umpire_host_aligned_allocator() {
+  static const umpire::Allocator s_allocator =
+      umpire::ResourceManager::getInstance()
+          .makeAllocator<UmpireAlignedHostStrategy>(umpire_host_aligned_name,
+                                                    MEMORY_ALIGNMENT);
+  return s_allocator;
+}
+
+namespace {
+
+bool umpire_make_host_aligned_allocator(const char *name) {
+  if (strcmp(name, umpire_host_aligned_name)) return false;
+  umpire_host_aligned_allocator();
+  return true;
+}
+
+}  // namespace
+
 umpire::Allocator get_allocator(const char *name) {
   auto &rm = umpire::ResourceManager::getInstance();
+
+  if (!rm.isAllocator(name)) {
+    // create the allocators Kokkos provides on first use
+    static std::mutex s_mutex;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!rm.isAllocator(name) && !umpire_make_host_aligned_allocator(name) &&
+        !umpire_make_huge_page_allocator(name) &&
+        !umpire_make_numa_allocator(name) &&
+        !umpire_make_file_allocator(name)) {
+      umpire_make_shared_allocator(name);
+    }
+  }
+
   return rm.getAllocator(name);
 }
 
-void *umpire_allocate(const char *name, const size_t arg_alloc_size) {
-  static_assert(sizeof(void *) == sizeof(uintptr_t),
-                "Error sizeof(void*) != sizeof(uintptr_t)");
+/* umpire_make_pool - create a pool allocator named name on top of upstream
+ * and register it with the resource manager.  Pool blocks are aligned to
+ * umpire_pool_alignment.  If an allocator with that
+ * name already exists it is returned as is, so that spaces can be made from
+ * the same pool repeatedly; umpire_allocator_alignment tells whether it is
+ * such a pool.
+ */
+umpire::Allocator umpire_make_pool(const char *name,
+                                   umpire::Allocator upstream,
+                                   size_t initial_bytes, size_t grow_bytes,
+                                   UmpirePoolStrategy strategy) {
+  auto &rm = umpire::ResourceManager::getInstance();
+
+  // pool blocks are aligned such that spaces never need to pad requests
+  const size_t alignment = umpire_pool_alignment;
+
+  if (rm.isAllocator(name)) return rm.getAllocator(name);
+
+  // report the blocks the pool acquires and releases
+  upstream = umpire_make_pool_upstream(name, upstream);
+
+  umpire::Allocator pool =
+      strategy == UmpirePoolStrategy::DynamicPoolList
+          ? rm.makeAllocator<umpire::strategy::DynamicPoolList>(
+                name, upstream, initial_bytes, grow_bytes, alignment)
+          : rm.makeAllocator<umpire::strategy::QuickPool>(
+                name, upstream, initial_bytes, grow_bytes, alignment);
+  umpire_pools().add(pool.getId());
+  return pool;
+}
 
-  static_assert(
-      Kokkos::Impl::is_integral_power_of_two(Kokkos::Impl::MEMORY_ALIGNMENT),
-      "Memory alignment must be power of two");
+/* umpire_make_thread_safe - wrap allocator in an Umpire ThreadSafeAllocator
+ * named "<allocator>::thread_safe", which serializes its calls on a lock.
+ * The wrapper is created once and returned as is afterwards, as is an
+ * allocator that is thread safe already.
+ */
+umpire::Allocator umpire_make_thread_safe(umpire::Allocator allocator) {
+  if (umpire_is_thread_safe(allocator)) return allocator;
+
+  auto &rm               = umpire::ResourceManager::getInstance();
+  const std::string name = allocator.getName() + "::thread_safe";
+
+  static std::mutex s_mutex;
+  std::lock_guard<std::mutex> lock(s_mutex);
+  if (rm.isAllocator(name)) return rm.getAllocator(name);
+  return rm.makeAllocator<umpire::strategy::ThreadSafeAllocator>(name,
+                                                                 allocator);
+}
+
+/* umpire_is_thread_safe - whether allocator may be called concurrently */
+bool umpire_is_thread_safe(umpire::Allocator allocator) {
+  return dynamic_cast<umpire::strategy::ThreadSafeAllocator *>(
+             allocator.getAllocationStrategy()) != nullptr;
+}
+
+/* umpire_allocator_alignment - the alignment allocations from allocator
+ * get without padding: that of malloc for plain host memory, MEMORY_ALIGNMENT
+ * for HOST_ALIGNED and the pools of umpire_make_pool, and that of the CUDA
+ * allocation routines otherwise.  The
+ * mapped strategies align what they map to their pages and the rest like
+ * their fallback.
+ */
+UmpireAllocatorAlignment umpire_allocator_alignment(
+    umpire::Allocator allocator) {
+  auto *const strategy = allocator.getAllocationStrategy();
+
+  UmpireAllocatorAlignment alignment;
+  alignment.alignment = umpire_strategy_alignment(strategy);
+#if defined(__linux__)
+  if (auto *const mapped = dynamic_cast<UmpireMappedStrategy *>(strategy)) {
+    alignment.alignment        = umpire_strategy_alignment(mapped->fallback());
+    alignment.mapped_alignment = mapped->page_bytes();
+    alignment.mapped_threshold = mapped->threshold();
+  }
+#endif
+  return alignment;
+}
 
-  constexpr uintptr_t alignment = Kokkos::Impl::MEMORY_ALIGNMENT;
+namespace {
 
+void *checked_umpire_allocate(umpire::Allocator &allocator,
+                              const size_t arg_alloc_size,
+                              const size_t alignment) {
   void *ptr = nullptr;
 
   if (arg_alloc_size) {
-    // Over-allocate to and round up to guarantee proper alignment.
-    size_t size_padded = arg_alloc_size + sizeof(void *) + alignment;
-
-    auto allocator = get_allocator(name);
-    ptr            = allocator.allocate(size_padded);
+    ptr = allocator.allocate(arg_alloc_size);
   }
 
   if (ptr == nullptr) {
@@ -268,14 +655,144 @@ void *umpire_allocate(const char *name, const size_t arg_alloc_size) {
   return ptr;
 }
 
-void umpire_deallocate(const char *name, void *const arg_alloc_ptr,
+}  // namespace
+
+/* umpire_allocate - allocate with whatever alignment the allocator gives */
+void *umpire_allocate(umpire::Allocator &allocator,
+                      const size_t arg_alloc_size) {
+  return checked_umpire_allocate(allocator, arg_alloc_size,
+                                 alignof(std::max_align_t));
+}
+
+/* umpire_allocate_aligned - allocate with more alignment than the allocator
+ *                           guarantees (at least that of malloc).  The
+ *                           request is padded by the alignment and the
+ *                           pointer rounded up past at least one pointer's
+ *                           worth of padding.  For host
+ *                           accessible memory the raw Umpire pointer is kept
+ *                           in that word, otherwise it is recovered from the
+ *                           allocation record on deallocation.
+ */
+void *umpire_allocate_aligned(umpire::Allocator &allocator,
+                              const size_t arg_alloc_size,
+                              const size_t alignment,
+                              const bool host_accessible) {
+  static_assert(sizeof(void *) == sizeof(uintptr_t),
+                "Error sizeof(void*) != sizeof(uintptr_t)");
+
+  void *const raw_ptr =
+      checked_umpire_allocate(allocator, arg_alloc_size + alignment, alignment);
+
+  const uintptr_t ptr =
+      (reinterpret_cast<uintptr_t>(raw_ptr) + sizeof(void *) + alignment - 1) &
+      ~(uintptr_t(alignment) - 1);
+
+  if (host_accessible) reinterpret_cast<void **>(ptr)[-1] = raw_ptr;
+
+  return reinterpret_cast<void *>(ptr);
+}
+
+void *umpire_allocate(const char *name, const size_t arg_alloc_size) {
+  auto allocator = get_allocator(name);
+  return umpire_allocate(allocator, arg_alloc_size);
+}
+
+void umpire_deallocate(umpire::Allocator &allocator, void *const arg_alloc_ptr,
                        const size_t) {
   if (arg_alloc_ptr) {
-    auto allocator = get_allocator(name);
     allocator.deallocate(const_cast<void *>(arg_alloc_ptr));
   }
 }
 
+void umpire_deallocate_aligned(umpire::Allocator &allocator,
+                               void *const arg_alloc_ptr,
+                               const size_t arg_alloc_size,
+                               const bool host_accessible) {
+  if (arg_alloc_ptr) {
+    void *raw_ptr;
+    if (host_accessible) {
+      raw_ptr = reinterpret_cast<void **>(arg_alloc_ptr)[-1];
+    } else {
+      auto &rm = umpire::ResourceManager::getInstance();
+      raw_ptr  = rm.findAllocationRecord(arg_alloc_ptr)->ptr;
+    }
+    umpire_deallocate(allocator, raw_ptr, arg_alloc_size);
+  }
+}
+
+/* umpire_reallocate - resize an allocation of the plain host allocator with
+ *                     Umpire's reallocate, i.e. realloc, which extends in
+ *                     place where it can and remaps large blocks instead of
+ *                     copying them.  For any other strategy Umpire would
+ *                     allocate, copy and deallocate, which the caller does
+ *                     better itself, so nullptr is returned.
+ */
+void *umpire_reallocate(umpire::Allocator &allocator, void *const arg_alloc_ptr,
+                        const size_t arg_alloc_size) {
+  auto &rm = umpire::ResourceManager::getInstance();
+
+  if (auto *const aligned = dynamic_cast<UmpireAlignedHostStrategy *>(
+          allocator.getAllocationStrategy())) {
+    // the strategy is not Umpire's, so move its allocation record by hand;
+    // before realloc, which may hand the old address out again
+    umpire::util::AllocationRecord record =
+        rm.deregisterAllocation(arg_alloc_ptr);
+    void *const ptr = aligned->reallocate(arg_alloc_ptr, arg_alloc_size);
+    if (ptr) {
+      record.ptr  = ptr;
+      record.size = arg_alloc_size;
+    }
+    rm.registerAllocation(record.ptr, record);
+    return ptr;
+  }
+
+  if (allocator.getAllocationStrategy() != umpire_host_strategy()) {
+    return nullptr;
+  }
+  return rm.reallocate(arg_alloc_ptr, arg_alloc_size);
+}
+
+/* umpire_reallocate_aligned - umpire_reallocate for host accessible
+ *                             allocations from umpire_allocate_aligned.  If
+ *                             the reallocated block is aligned differently
+ *                             the contents are moved to the new aligned
+ *                             pointer, which realloc'ed (page aligned) large
+ *                             blocks never need.
+ */
+void *umpire_reallocate_aligned(umpire::Allocator &allocator,
+                                void *const arg_alloc_ptr,
+                                const size_t old_size, const size_t new_size,
+                                const size_t alignment) {
+  char *const raw_old =
+      static_cast<char *>(reinterpret_cast<void **>(arg_alloc_ptr)[-1]);
+  const size_t offset_old = static_cast<char *>(arg_alloc_ptr) - raw_old;
+
+  char *const raw_new = static_cast<char *>(
+      umpire_reallocate(allocator, raw_old, new_size + alignment));
+  if (raw_new == nullptr) return nullptr;
+
+  const uintptr_t ptr =
+      (reinterpret_cast<uintptr_t>(raw_new) + sizeof(void *) + alignment - 1) &
+      ~(uintptr_t(alignment) - 1);
+  const size_t offset_new = reinterpret_cast<char *>(ptr) - raw_new;
+
+  if (offset_new != offset_old) {
+    memmove(raw_new + offset_new, raw_new + offset_old,
+            std::min(old_size, new_size));
+  }
+  reinterpret_cast<void **>(ptr)[-1] = raw_new;
+
+  return reinterpret_cast<void *>(ptr);
+}
+
+void umpire_deallocate(const char *name, void *const arg_alloc_ptr,
+                       const size_t arg_alloc_size) {
+  if (arg_alloc_ptr) {
+    auto allocator = get_allocator(name);
+    umpire_deallocate(allocator, arg_alloc_ptr, arg_alloc_size);
+  }
+}
+
 }  // namespace Impl
 }  // namespace Kokkos
 
@@ -0,0 +1,187 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+/* UmpireArena - monotonic bump allocator over blocks obtained from an
+ *               Umpire allocator.
+ *
+ * Allocation bumps an offset into the current block, deallocation only
+ * counts the allocation as dead.  reset() reclaims everything at once by
+ * rewinding to the first block; the blocks themselves are kept for reuse
+ * and only handed back to the upstream allocator when the arena is
+ * destroyed, i.e. when the last space (and View) referring to it goes away.
+ */
+class UmpireArena {
+ public:
+  UmpireArena(const umpire::Allocator& upstream, const size_t block_bytes,
+              const size_t alignment)
+      : m_upstream(upstream),
+        m_block_bytes(block_bytes),
+        m_alignment(alignment) {}
+
+  ~UmpireArena() {
+    for (auto& block : m_blocks) {
+      umpire_deallocate(m_upstream, block.alloc_ptr, block.size + m_alignment);
+    }
+  }
+
+  void* allocate(const size_t arg_alloc_size) {
+    const size_t n = (arg_alloc_size + m_alignment - 1) & ~(m_alignment - 1);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_blocks.empty() || m_offset + n > m_blocks[m_current].size) {
+      next_block(n);
+    }
+
+    void* const ptr = m_blocks[m_current].ptr + m_offset;
+    m_offset += n;
+    ++m_live;
+    return ptr;
+  }
+
+  void deallocate() { --m_live; }
+
+  // grow or shrink the allocation at ptr in place, which works for the most
+  // recent allocation as long as its block has room
+  bool reallocate(void* const ptr, const size_t old_size,
+                  const size_t new_size) {
+    const size_t n_old = (old_size + m_alignment - 1) & ~(m_alignment - 1);
+    const size_t n_new = (new_size + m_alignment - 1) & ~(m_alignment - 1);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_blocks.empty() || m_offset < n_old) return false;
+    const size_t offset = m_offset - n_old;
+    if (m_blocks[m_current].ptr + offset != ptr ||
+        offset + n_new > m_blocks[m_current].size) {
+      return false;
+    }
+    m_offset = offset + n_new;
+    return true;
+  }
+
+  void reset() {
+    if (m_live != 0) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::reset ERROR: the arena still has live "
+          "allocations");
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_current = 0;
+    m_offset  = 0;
+  }
+
+ private:
+  struct Block {
+    void* alloc_ptr;
+    char* ptr;
+    size_t size;
+  };
+
+  // move on to the next block with room for n bytes, reusing blocks from
+  // before the last reset where possible
+  void next_block(const size_t n) {
+    if (!m_blocks.empty()) ++m_current;
+    m_offset = 0;
+
+    if (m_current < m_blocks.size() && n <= m_blocks[m_current].size) return;
+
+    Block block;
+    block.size      = std::max(n, m_block_bytes);
+    block.alloc_ptr = umpire_allocate(m_upstream, block.size + m_alignment);
+
+    const uintptr_t misalignment =
+        reinterpret_cast<uintptr_t>(block.alloc_ptr) % m_alignment;
+    block.ptr = static_cast<char*>(block.alloc_ptr) +
+                (misalignment ? m_alignment - misalignment : 0);
+
+    m_blocks.insert(m_blocks.begin() + m_current, block);
+  }
+
+  umpire::Allocator m_upstream;
+  const size_t m_block_bytes;
+  const size_t m_alignment;
+  std::mutex m_mutex;
+  std::vector<Block> m_blocks;
+  size_t m_current = 0;
+  size_t m_offset  = 0;
+  std::atomic<size_t> m_live{0};
+};
+
+std::shared_ptr<UmpireArena> umpire_make_arena(umpire::Allocator allocator,
+                                               const size_t block_bytes,
+                                               const size_t alignment) {
+  return std::make_shared<UmpireArena>(allocator, block_bytes, alignment);
+}
+
+void* umpire_arena_allocate(UmpireArena* arena, const size_t arg_alloc_size) {
+  return arena->allocate(arg_alloc_size);
+}
+
+void umpire_arena_deallocate(UmpireArena* arena) { arena->deallocate(); }
+
+void* umpire_arena_reallocate(UmpireArena* arena, void* const ptr,
+                              const size_t old_size, const size_t new_size) {
+  return arena->reallocate(ptr, old_size, new_size) ? ptr : nullptr;
+}
+
+void umpire_arena_reset(UmpireArena* arena) { arena->reset(); }
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,253 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace_DeepCopyBatch.hpp>
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+constexpr size_t umpire_copy_chunk_alignment = 4096;
+
+std::atomic<size_t>& umpire_parallel_copy_threshold_value() {
+  static std::atomic<size_t> s_threshold([] {
+    const char* env = std::getenv("KOKKOS_UMPIRE_PARALLEL_COPY_THRESHOLD");
+    return env ? size_t(std::strtoull(env, nullptr, 10)) : size_t(1) << 20;
+  }());
+  return s_threshold;
+}
+
+/* umpire_for_each_chunk - call f(begin, end) for one chunk of the n bytes at
+ * dst per thread of exec, on a static schedule so that thread k always
+ * writes the k-th part of dst (and a dst placed by first touch under the
+ * same schedule stays node local).  Chunk boundaries are page aligned in
+ * dst, so no page is written by two threads.
+ */
+template <class Functor>
+void umpire_for_each_chunk(const Kokkos::DefaultHostExecutionSpace& exec,
+                           const char* label, void* dst, const size_t n,
+                           const Functor& f) {
+  const size_t chunks = std::max(1, exec.concurrency());
+  const size_t align  = umpire_copy_chunk_alignment;
+  const size_t chunk  = ((n + chunks - 1) / chunks + align - 1) & ~(align - 1);
+  const uintptr_t base = reinterpret_cast<uintptr_t>(dst);
+
+  Kokkos::parallel_for(
+      label,
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace,
+                          Kokkos::Schedule<Kokkos::Static>>(exec, 0, chunks),
+      [=](const size_t k) {
+        auto boundary = [=](const size_t i) -> size_t {
+          if (i == 0) return 0;
+          if (i == chunks) return n;
+          const uintptr_t b = (base + i * chunk + align - 1) & ~(align - 1);
+          return std::min<size_t>(n, b - base);
+        };
+        const size_t begin = boundary(k);
+        const size_t end   = boundary(k + 1);
+        if (begin < end) f(begin, end);
+      });
+}
+
+void umpire_chunked_copy(const Kokkos::DefaultHostExecutionSpace& exec,
+                         void* dst, const void* src, const size_t n) {
+  umpire_for_each_chunk(
+      exec, "Kokkos::Impl::umpire_host_deep_copy", dst, n,
+      [=](const size_t begin, const size_t end) {
+        std::memcpy(static_cast<char*>(dst) + begin,
+                    static_cast<const char*>(src) + begin, end - begin);
+      });
+}
+
+}  // namespace
+
+/* umpire_host_can_dispatch - whether kernels can be dispatched to the
+ * default host execution space here: Kokkos is initialized and this is not
+ * a thread of one of its parallel regions.
+ */
+bool umpire_host_can_dispatch() {
+  return Kokkos::is_initialized() &&
+         !Kokkos::DefaultHostExecutionSpace().in_parallel();
+}
+
+size_t umpire_parallel_copy_threshold() {
+  return umpire_parallel_copy_threshold_value().load(
+      std::memory_order_relaxed);
+}
+
+void umpire_set_parallel_copy_threshold(const size_t bytes) {
+  umpire_parallel_copy_threshold_value().store(bytes,
+                                               std::memory_order_relaxed);
+}
+
+/* umpire_host_parallel_deep_copy - synchronous copy between host accessible
+ * buffers on the default host execution space, e.g. for checkpoint staging
+ * where a single core cannot saturate the memory bandwidth of a socket.
+ */
+void umpire_host_parallel_deep_copy(void* dst, const void* src,
+                                    const size_t n) {
+  if (!umpire_host_can_dispatch()) {
+    std::memcpy(dst, src, n);
+    return;
+  }
+  Kokkos::DefaultHostExecutionSpace exec;
+  umpire_chunked_copy(exec, dst, src, n);
+  exec.fence();
+}
+
+/* umpire_host_deep_copy_async - enqueue a copy between host accessible
+ * buffers on the given instance of the default host execution space.  It
+ * runs in order with the kernels submitted to the instance, so the caller
+ * only has to fence that instance before using dst on the host.  Large
+ * copies are chunked over the threads of the instance.
+ */
+void umpire_host_deep_copy_async(const Kokkos::DefaultHostExecutionSpace& exec,
+                                 void* dst, const void* src, size_t n) {
+  if (n >= umpire_parallel_copy_threshold()) {
+    umpire_chunked_copy(exec, dst, src, n);
+    return;
+  }
+  Kokkos::parallel_for(
+      "Kokkos::Impl::umpire_host_deep_copy_async",
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(exec, 0, 1),
+      [=](const int) { std::memcpy(dst, src, n); });
+}
+
+/* umpire_host_deep_copy_batch_async - enqueue a batch of copies between
+ * host accessible buffers on exec: copies above the parallel copy threshold
+ * are chunked over the threads one after the other, the others are spread
+ * over the threads by a single kernel, one copy per iteration.  Each copy
+ * is reported to Kokkos Tools and traced like a single deep copy.
+ */
+void umpire_host_deep_copy_batch_async(
+    const Kokkos::DefaultHostExecutionSpace& exec,
+    const std::vector<UmpireCopySegment>& segments) {
+  const size_t threshold = umpire_parallel_copy_threshold();
+
+  // captured by the kernel, so it lives until the kernel has run
+  Kokkos::View<UmpireCopySegment*, Kokkos::HostSpace> small(
+      Kokkos::view_alloc("Kokkos::Impl::umpire_host_deep_copy_batch",
+                         Kokkos::WithoutInitializing),
+      segments.size());
+  size_t count = 0;
+  for (const UmpireCopySegment& segment : segments) {
+    UmpireDeepCopyProfile profile(segment.dst, segment.dst_is_umpire,
+                                  segment.src, segment.src_is_umpire,
+                                  segment.bytes);
+    if (segment.bytes >= threshold) {
+      umpire_chunked_copy(exec, segment.dst, segment.src, segment.bytes);
+    } else {
+      small(count++) = segment;
+    }
+  }
+  if (count == 0) return;
+
+  Kokkos::parallel_for(
+      "Kokkos::Impl::umpire_host_deep_copy_batch",
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(exec, 0, count),
+      [=](const size_t i) {
+        std::memcpy(small(i).dst, small(i).src, small(i).bytes);
+      });
+}
+
+/* umpire_host_fill - memset of host accessible memory, chunked over the
+ * threads of the default host execution space like a copy from the parallel
+ * copy threshold on, since a single core cannot saturate the bandwidth of
+ * a socket when zeroing large accumulation buffers either.  Inside a
+ * parallel region (allocations of a thread safe space) it is a plain memset.
+ */
+void umpire_host_fill(void* ptr, const int value, const size_t n) {
+  if (n < umpire_parallel_copy_threshold() || !umpire_host_can_dispatch()) {
+    std::memset(ptr, value, n);
+    return;
+  }
+  Kokkos::DefaultHostExecutionSpace exec;
+  umpire_for_each_chunk(exec, "Kokkos::Impl::umpire_host_fill", ptr, n,
+                        [=](const size_t begin, const size_t end) {
+                          std::memset(static_cast<char*>(ptr) + begin, value,
+                                      end - begin);
+                        });
+  exec.fence();
+}
+
+/* umpire_memset - fill memory that is not host accessible with the Umpire
+ * MEMSET operation of its allocation.
+ */
+void umpire_memset(void* ptr, const int value, const size_t n) {
+  auto& rm = umpire::ResourceManager::getInstance();
+  rm.memset(ptr, value, n);
+}
+
+/* umpire_is_fresh_mapping - allocations of the mapped strategies (huge
+ * pages) are zero pages that have not even been touched yet, so zeroing
+ * them would only fault them in to write what is already there.
+ */
+bool umpire_is_fresh_mapping(umpire::Allocator& allocator, const void* ptr,
+                             const size_t n) {
+#if defined(__linux__)
+  auto* const mapped =
+      dynamic_cast<UmpireMappedStrategy*>(allocator.getAllocationStrategy());
+  return mapped && ptr && mapped->is_mapped(ptr, n);
+#else
+  (void)allocator;
+  (void)ptr;
+  (void)n;
+  return false;
+#endif
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,205 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+constexpr const char* umpire_file_full       = "_FULL";
+constexpr const char* umpire_file_sequential = "_SEQUENTIAL";
+constexpr const char* umpire_file_random     = "_RANDOM";
+
+/* umpire_parse_file_allocator_name - the options encoded in the name of a
+ * HOST_FILE allocator (see umpire_file_allocator_name); false if name is
+ * not one.
+ */
+bool umpire_parse_file_allocator_name(const char* name,
+                                      UmpireFileOptions& options) {
+  const size_t prefix = strlen(umpire_file_prefix);
+  if (strncmp(name, umpire_file_prefix, prefix)) return false;
+
+  const char* p           = name + prefix;
+  const char* const colon = strchr(p, ':');
+  const char* const end   = colon ? colon : p + strlen(p);
+
+  auto flag = [&](const char* f) {
+    const size_t n = strlen(f);
+    if (size_t(end - p) < n || strncmp(p, f, n)) return false;
+    p += n;
+    return true;
+  };
+  while (p != end) {
+    if (flag(umpire_file_full)) {
+      options.sparse = false;
+    } else if (flag(umpire_file_sequential)) {
+      options.access = UmpireFileAccess::Sequential;
+    } else if (flag(umpire_file_random)) {
+      options.access = UmpireFileAccess::Random;
+    } else {
+      return false;
+    }
+  }
+  if (colon) options.directory = colon + 1;
+  return true;
+}
+
+#if defined(__linux__)
+
+/* UmpireFileStrategy - host allocation strategy that maps requests of at
+ * least threshold bytes from files created (and unlinked at once) in a
+ * directory, so their pages are backed by the file rather than by swap and
+ * the page cache pages them in and out.  Smaller requests go to the
+ * fallback strategy.
+ */
+class UmpireFileStrategy : public UmpireMappedStrategy {
+ public:
+  UmpireFileStrategy(const std::string& name, int id,
+                     umpire::Allocator fallback, size_t threshold,
+                     const UmpireFileOptions& options)
+      : UmpireMappedStrategy(name, id, fallback, threshold,
+                             system_page_bytes()),
+        m_directory(options.directory),
+        m_sparse(options.sparse),
+        m_advice(options.access == UmpireFileAccess::Sequential
+                     ? MADV_SEQUENTIAL
+                     : options.access == UmpireFileAccess::Random
+                           ? MADV_RANDOM
+                           : MADV_NORMAL) {}
+
+ protected:
+  void* map_pages(const size_t size) override {
+    std::string path = m_directory + "/kokkos_umpire_XXXXXX";
+    const int fd     = mkstemp(&path[0]);
+    if (fd < 0) failure("cannot create a file in " + m_directory);
+    // the file lives on as long as it is mapped
+    unlink(path.c_str());
+
+    const int error =
+        m_sparse ? (ftruncate(fd, size) ? errno : 0)
+                 : posix_fallocate(fd, 0, static_cast<off_t>(size));
+    void* const ptr =
+        error ? MAP_FAILED
+              : mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (error) {
+      errno = error;
+      failure("cannot size a file in " + m_directory);
+    }
+    if (ptr == MAP_FAILED) return nullptr;
+
+    if (m_advice != MADV_NORMAL) madvise(ptr, size, m_advice);
+    return ptr;
+  }
+
+ private:
+  [[noreturn]] static void failure(const std::string& what) {
+    Kokkos::Impl::throw_runtime_exception("Kokkos::UmpireSpace ERROR: " +
+                                          what + ": " + strerror(errno));
+  }
+
+  const std::string m_directory;
+  const bool m_sparse;
+  const int m_advice;
+};
+
+#endif
+
+}  // namespace
+
+/* umpire_file_allocator_name - HOST_FILE followed by a flag for each option
+ * that differs from the default and by ":<directory>" if one is given.
+ */
+std::string umpire_file_allocator_name(const UmpireFileOptions& options) {
+  std::string name = umpire_file_prefix;
+  if (!options.sparse) name += umpire_file_full;
+  if (options.access == UmpireFileAccess::Sequential) {
+    name += umpire_file_sequential;
+  } else if (options.access == UmpireFileAccess::Random) {
+    name += umpire_file_random;
+  }
+  if (!options.directory.empty()) name += ":" + options.directory;
+  return name;
+}
+
+bool umpire_make_file_allocator(const char* name) {
+  UmpireFileOptions options;
+  if (!umpire_parse_file_allocator_name(name, options)) return false;
+
+#if defined(__linux__)
+  if (options.directory.empty()) {
+    const char* tmpdir = std::getenv("TMPDIR");
+    options.directory  = tmpdir && *tmpdir ? tmpdir : "/tmp";
+  }
+
+  auto& rm = umpire::ResourceManager::getInstance();
+  rm.makeAllocator<UmpireFileStrategy>(name, umpire_host_aligned_allocator(),
+                                       umpire_file_threshold, options);
+  return true;
+#else
+  Kokkos::Impl::throw_runtime_exception(
+      std::string("Kokkos::UmpireSpace ERROR: ") + name +
+      " allocators are only available on Linux");
+#endif
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,129 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <cstring>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+#if defined(__linux__)
+
+namespace {
+
+/* UmpireHugePageStrategy - host allocation strategy that backs requests of
+ * at least threshold bytes with 2 MiB huge pages: either explicit ones
+ * (MAP_HUGETLB, when asked for and the system has reserved them) or
+ * transparent ones (a 2 MiB aligned anonymous mapping advised with
+ * MADV_HUGEPAGE).  Smaller requests go to the fallback strategy.
+ */
+class UmpireHugePageStrategy : public UmpireMappedStrategy {
+ public:
+  UmpireHugePageStrategy(const std::string& name, int id,
+                         umpire::Allocator fallback, size_t threshold,
+                         bool use_hugetlb)
+      : UmpireMappedStrategy(name, id, fallback, threshold,
+                             umpire_huge_page_bytes),
+        m_use_hugetlb(use_hugetlb) {}
+
+ protected:
+  void* map_pages(const size_t size) override {
+#if defined(MAP_HUGETLB)
+    if (m_use_hugetlb) {
+      void* ptr = map_anonymous(size, system_page_bytes(), MAP_HUGETLB);
+      if (ptr != nullptr) return ptr;
+      // no (or not enough) reserved huge pages, use transparent ones
+    }
+#endif
+
+    // 2 MiB aligned, so the kernel can back all of it with huge pages
+    void* ptr = map_anonymous(size, umpire_huge_page_bytes);
+
+#if defined(MADV_HUGEPAGE)
+    // failure only means transparent huge pages are disabled
+    if (ptr != nullptr) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+    return ptr;
+  }
+
+ private:
+  const bool m_use_hugetlb;
+};
+
+}  // namespace
+
+bool umpire_make_huge_page_allocator(const char* name) {
+  const bool use_hugetlb = !strcmp(name, umpire_hugetlb_name);
+  if (!use_hugetlb && strcmp(name, umpire_huge_page_name)) return false;
+
+  auto& rm = umpire::ResourceManager::getInstance();
+  rm.makeAllocator<UmpireHugePageStrategy>(
+      name, umpire_host_aligned_allocator(), umpire_huge_page_threshold,
+      use_hugetlb);
+  return true;
+}
+
+#else
+
+bool umpire_make_huge_page_allocator(const char* name) {
+  if (strcmp(name, umpire_huge_page_name) &&
+      strcmp(name, umpire_hugetlb_name)) {
+    return false;
+  }
+  Kokkos::Impl::throw_runtime_exception(
+      std::string("Kokkos::UmpireSpace ERROR: ") + name +
+      " allocators are only available on Linux");
+}
+
+#endif
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,187 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#ifndef KOKKOS_UMPIRESPACE_MAPPEDSTRATEGY_HPP
+#define KOKKOS_UMPIRESPACE_MAPPEDSTRATEGY_HPP
+
+#include <Kokkos_Macros.hpp>
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "umpire/Allocator.hpp"
+#include "umpire/strategy/AllocationStrategy.hpp"
+
+namespace Kokkos {
+
+namespace Impl {
+
+/* UmpireMappedStrategy - base of the host allocation strategies that back
+ * requests of at least threshold bytes with memory mappings of whole pages
+ * of page_bytes, set up by the derived class in map_pages.  Smaller requests
+ * go to the fallback strategy.  The sizes of the mappings are kept so that
+ * deallocate can tell them apart from fallback allocations and unmap them.
+ * A mapping serves a single allocation and is unmapped with it, so memory
+ * in a mapping is fresh, i.e. zero, when it is handed out.
+ */
+class UmpireMappedStrategy : public umpire::strategy::AllocationStrategy {
+ public:
+  UmpireMappedStrategy(const std::string& name, int id,
+                       umpire::Allocator fallback, size_t threshold,
+                       size_t page_bytes)
+      : umpire::strategy::AllocationStrategy(name, id),
+        m_fallback(fallback.getAllocationStrategy()),
+        m_threshold(threshold),
+        m_page_bytes(page_bytes) {}
+
+  void* allocate(std::size_t bytes) override {
+    if (bytes < m_threshold) return m_fallback->allocate(bytes);
+
+    const size_t size =
+        (bytes + m_page_bytes - 1) / m_page_bytes * m_page_bytes;
+
+    void* ptr = map_pages(size);
+    if (ptr == nullptr) return nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped[ptr] = size;
+    return ptr;
+  }
+
+  void deallocate(void* ptr) override {
+    size_t size = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_mapped.find(ptr);
+      if (it != m_mapped.end()) {
+        size = it->second;
+        m_mapped.erase(it);
+      }
+    }
+
+    if (size) {
+      unmap_pages(ptr, size);
+    } else {
+      m_fallback->deallocate(ptr);
+    }
+  }
+
+  umpire::Platform getPlatform() noexcept override {
+    return umpire::Platform::host;
+  }
+
+  /**\brief  Requests of at least threshold() bytes are mapped, aligned to
+   *         page_bytes(); the others go to fallback()
+   */
+  size_t threshold() const { return m_threshold; }
+  size_t page_bytes() const { return m_page_bytes; }
+  umpire::strategy::AllocationStrategy* fallback() const { return m_fallback; }
+
+  /**\brief  Whether [ptr, ptr + bytes) lies in a single mapping */
+  bool is_mapped(const void* ptr, const size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapped.upper_bound(const_cast<void*>(ptr));
+    if (it == m_mapped.begin()) return false;
+    --it;
+    const char* const begin = static_cast<const char*>(it->first);
+    return static_cast<const char*>(ptr) + bytes <= begin + it->second;
+  }
+
+ protected:
+  /**\brief  Map size bytes, a multiple of page_bytes; nullptr on failure */
+  virtual void* map_pages(const size_t size) = 0;
+
+  virtual void unmap_pages(void* ptr, const size_t size) { munmap(ptr, size); }
+
+  /**\brief  Anonymous private mapping of size bytes aligned to alignment.
+   *
+   *  Over-maps by alignment and trims the mapping when alignment is larger
+   *  than the system page size.
+   */
+  static void* map_anonymous(const size_t size, const size_t alignment,
+                             const int flags = 0) {
+    const size_t extra = alignment > system_page_bytes() ? alignment : 0;
+
+    char* const raw = static_cast<char*>(
+        mmap(nullptr, size + extra, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0));
+    if (raw == MAP_FAILED) return nullptr;
+    if (extra == 0) return raw;
+
+    char* const ptr = reinterpret_cast<char*>(
+        (reinterpret_cast<uintptr_t>(raw) + alignment - 1) &
+        ~uintptr_t(alignment - 1));
+
+    const size_t head = ptr - raw;
+    if (head) munmap(raw, head);
+    if (head != extra) munmap(ptr + size, extra - head);
+
+    return ptr;
+  }
+
+  static size_t system_page_bytes() {
+    static const size_t s_bytes = sysconf(_SC_PAGESIZE);
+    return s_bytes;
+  }
+
+ private:
+  umpire::strategy::AllocationStrategy* m_fallback;
+  const size_t m_threshold;
+  const size_t m_page_bytes;
+  std::mutex m_mutex;
+  std::map<void*, size_t> m_mapped;
+};
+
+}  // namespace Impl
+}  // namespace Kokkos
+
+#endif  // defined(__linux__)
+
+#endif  // KOKKOS_UMPIRESPACE_MAPPEDSTRATEGY_HPP
@@ -0,0 +1,262 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <impl/Kokkos_Error.hpp>
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
+
+#if defined(UMPIRE_ENABLE_NUMA)
+#include "umpire/strategy/NumaPolicy.hpp"
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+bool umpire_numa_node_online(const int node) {
+  for (int n : umpire_numa_nodes()) {
+    if (n == node) return true;
+  }
+  return false;
+}
+
+#if defined(__linux__)
+
+#if !defined(MPOL_BIND)
+#define MPOL_BIND 2
+#endif
+#if !defined(MPOL_INTERLEAVE)
+#define MPOL_INTERLEAVE 3
+#endif
+
+using umpire_node_mask = unsigned long;
+constexpr int umpire_max_numa_nodes = 8 * sizeof(umpire_node_mask);
+
+/* UmpireNumaStrategy - host allocation strategy that maps requests of at
+ * least threshold bytes and sets the NUMA memory policy of the mapping to
+ * mode (MPOL_BIND or MPOL_INTERLEAVE) over the nodes in mask before any
+ * page of it is touched.  The policy is set with the mbind system call
+ * directly so that libnuma is not needed; if it fails (no NUMA support in
+ * the kernel) the pages are placed as usual.
+ */
+class UmpireNumaStrategy : public UmpireMappedStrategy {
+ public:
+  UmpireNumaStrategy(const std::string& name, int id,
+                     umpire::Allocator fallback, size_t threshold, int mode,
+                     umpire_node_mask mask)
+      : UmpireMappedStrategy(name, id, fallback, threshold,
+                             system_page_bytes()),
+        m_mode(mode),
+        m_mask(mask) {}
+
+ protected:
+  void* map_pages(const size_t size) override {
+    void* ptr = map_anonymous(size, system_page_bytes());
+#if defined(SYS_mbind)
+    // the kernel reads maxnode - 1 bits of the mask
+    if (ptr != nullptr) {
+      syscall(SYS_mbind, ptr, size, m_mode, &m_mask, umpire_max_numa_nodes + 1,
+              0);
+    }
+#endif
+    return ptr;
+  }
+
+ private:
+  const int m_mode;
+  const umpire_node_mask m_mask;
+};
+
+void umpire_make_numa_allocator(const std::string& name, const int mode,
+                                const umpire_node_mask mask) {
+  auto& rm = umpire::ResourceManager::getInstance();
+  rm.makeAllocator<UmpireNumaStrategy>(name, umpire_host_aligned_allocator(),
+                                       umpire_numa_threshold, mode, mask);
+}
+
+#endif
+
+}  // namespace
+
+/* umpire_numa_nodes - the online NUMA nodes, read once from sysfs, where
+ * the list has the form "0-3,5".  A single node 0 if it cannot be read.
+ */
+const std::vector<int>& umpire_numa_nodes() {
+  static const std::vector<int> s_nodes = [] {
+    std::vector<int> nodes;
+#if defined(__linux__)
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string list;
+    if (online >> list) {
+      const char* p = list.c_str();
+      while (true) {
+        char* end;
+        const int first = std::strtol(p, &end, 10);
+        if (end == p) break;
+        int last = first;
+        if (*end == '-') last = std::strtol(end + 1, &end, 10);
+        for (int node = first; node <= last; ++node) nodes.push_back(node);
+        if (*end != ',') break;
+        p = end + 1;
+      }
+    }
+#endif
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+  }();
+  return s_nodes;
+}
+
+int umpire_numa_node_count() { return umpire_numa_nodes().size(); }
+
+/* umpire_make_numa_allocator - create the HOST_NUMA_INTERLEAVE or
+ * HOST_NUMA_BIND_<n> allocator if name is one of those, binding with
+ * Umpire's NumaPolicy when Umpire was built with NUMA support.
+ */
+bool umpire_make_numa_allocator(const char* name) {
+  const size_t prefix = strlen(umpire_numa_bind_prefix);
+  const bool bind     = !strncmp(name, umpire_numa_bind_prefix, prefix);
+  if (!bind && strcmp(name, umpire_numa_interleave_name)) return false;
+
+#if defined(__linux__)
+  if (bind) {
+    char* end;
+    const long node = std::strtol(name + prefix, &end, 10);
+    if (end == name + prefix || *end || node < 0 ||
+        node >= umpire_max_numa_nodes || !umpire_numa_node_online(node)) {
+      Kokkos::Impl::throw_runtime_exception(
+          std::string("Kokkos::UmpireSpace ERROR: ") + name +
+          " does not name an online NUMA node");
+    }
+#if defined(UMPIRE_ENABLE_NUMA)
+    auto& rm = umpire::ResourceManager::getInstance();
+    rm.makeAllocator<umpire::strategy::NumaPolicy>(
+        name, rm.getAllocator("HOST"), static_cast<int>(node));
+#else
+    umpire_make_numa_allocator(name, MPOL_BIND, umpire_node_mask(1) << node);
+#endif
+  } else {
+    umpire_node_mask mask = 0;
+    for (int node : umpire_numa_nodes()) {
+      if (node < umpire_max_numa_nodes) mask |= umpire_node_mask(1) << node;
+    }
+    umpire_make_numa_allocator(name, MPOL_INTERLEAVE, mask);
+  }
+  return true;
+#else
+  Kokkos::Impl::throw_runtime_exception(
+      std::string("Kokkos::UmpireSpace ERROR: ") + name +
+      " allocators are only available on Linux");
+#endif
+}
+
+umpire::Allocator umpire_numa_allocator(const UmpireNumaPolicy policy,
+                                        const int node) {
+  if (policy == UmpireNumaPolicy::Interleave) {
+    return get_allocator(umpire_numa_interleave_name);
+  }
+  return get_allocator(
+      (umpire_numa_bind_prefix + std::to_string(node)).c_str());
+}
+
+/* umpire_first_touch - write one byte of every page of [ptr, ptr + size) from
+ * the thread of the default host execution space that a static schedule
+ * over the pages assigns it to, so that the first-touch policy of the
+ * kernel puts each page on the NUMA node of the thread that will work on it
+ * in a statically scheduled loop over the allocation.
+ */
+void umpire_first_touch(void* ptr, const size_t size) {
+  if (ptr == nullptr || size < umpire_first_touch_min_bytes ||
+      !Kokkos::is_initialized()) {
+    return;
+  }
+
+#if defined(__linux__)
+  static const size_t s_page = sysconf(_SC_PAGESIZE);
+#else
+  static const size_t s_page = 4096;
+#endif
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(ptr);
+  const uintptr_t end   = begin + size;
+  const size_t pages    = (end - 1) / s_page - begin / s_page + 1;
+
+  auto touch = [=](const size_t i) {
+    const uintptr_t page = (begin / s_page + i) * s_page;
+    *reinterpret_cast<volatile char*>(page < begin ? begin : page) = 0;
+  };
+
+  // no kernel can be dispatched from a parallel region (allocations of a
+  // thread safe space), so the pages go to the node of this thread there
+  if (!umpire_host_can_dispatch()) {
+    for (size_t i = 0; i < pages; ++i) touch(i);
+    return;
+  }
+
+  using policy_type =
+      Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace,
+                          Kokkos::Schedule<Kokkos::Static>>;
+  Kokkos::parallel_for("Kokkos::UmpireSpace::first_touch",
+                       policy_type(0, pages), touch);
+  Kokkos::DefaultHostExecutionSpace().fence();
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,486 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <impl/Kokkos_Error.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+/* UmpireConfigValue - the subset of JSON the prewarm configuration uses:
+ * objects, arrays, strings, numbers and booleans.
+ */
+struct UmpireConfigValue {
+  enum class Kind { Null, Boolean, Number, String, Array, Object };
+
+  Kind kind = Kind::Null;
+  bool boolean = false;
+  double number = 0;
+  std::string string;
+  std::vector<UmpireConfigValue> array;
+  std::vector<std::pair<std::string, UmpireConfigValue>> object;
+
+  const UmpireConfigValue* find(const char* key) const {
+    for (const auto& member : object) {
+      if (member.first == key) return &member.second;
+    }
+    return nullptr;
+  }
+};
+
+class UmpireConfigParser {
+ public:
+  UmpireConfigParser(const std::string& text, const std::string& source)
+      : m_text(text), m_source(source) {}
+
+  UmpireConfigValue parse() {
+    UmpireConfigValue value = parse_value();
+    skip_space();
+    if (m_pos != m_text.size()) error("trailing characters");
+    return value;
+  }
+
+ private:
+  UmpireConfigValue parse_value() {
+    skip_space();
+    if (m_pos == m_text.size()) error("unexpected end");
+
+    UmpireConfigValue value;
+    const char c = m_text[m_pos];
+    if (c == '{') {
+      value.kind = UmpireConfigValue::Kind::Object;
+      ++m_pos;
+      if (!consume('}')) {
+        do {
+          skip_space();
+          std::string key = parse_string();
+          if (!consume(':')) error("expected ':'");
+          value.object.emplace_back(std::move(key), parse_value());
+        } while (consume(','));
+        if (!consume('}')) error("expected '}'");
+      }
+    } else if (c == '[') {
+      value.kind = UmpireConfigValue::Kind::Array;
+      ++m_pos;
+      if (!consume(']')) {
+        do {
+          value.array.push_back(parse_value());
+        } while (consume(','));
+        if (!consume(']')) error("expected ']'");
+      }
+    } else if (c == '"') {
+      value.kind   = UmpireConfigValue::Kind::String;
+      value.string = parse_string();
+    } else if (keyword("true") || keyword("false")) {
+      value.kind    = UmpireConfigValue::Kind::Boolean;
+      value.boolean = c == 't';
+    } else if (keyword("null")) {
+    } else {
+      const char* begin = m_text.c_str() + m_pos;
+      char* end;
+      value.kind   = UmpireConfigValue::Kind::Number;
+      value.number = std::strtod(begin, &end);
+      if (end == begin) error("unexpected character");
+      m_pos += end - begin;
+    }
+    return value;
+  }
+
+  std::string parse_string() {
+    if (!consume('"')) error("expected a string");
+    std::string s;
+    while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+      const char c = m_text[m_pos++];
+      if (static_cast<unsigned char>(c) < 0x20) error("control character");
+      if (c != '\\') {
+        s += c;
+        continue;
+      }
+      if (m_pos == m_text.size()) break;
+      switch (m_text[m_pos++]) {
+        case '"': s += '"'; break;
+        case '\\': s += '\\'; break;
+        case '/': s += '/'; break;
+        case 'b': s += '\b'; break;
+        case 'f': s += '\f'; break;
+        case 'n': s += '\n'; break;
+        case 'r': s += '\r'; break;
+        case 't': s += '\t'; break;
+        case 'u': append_utf8(s, parse_code_point()); break;
+        default: --m_pos; error("invalid escape");
+      }
+    }
+    if (!consume('"')) error("unterminated string");
+    return s;
+  }
+
+  // the code point of a \uXXXX escape, or of a surrogate pair of two
+  unsigned parse_code_point() {
+    unsigned code = parse_hex4();
+    if (code >= 0xD800 && code < 0xDC00) {
+      if (m_text.compare(m_pos, 2, "\\u") != 0) error("unpaired surrogate");
+      m_pos += 2;
+      const unsigned low = parse_hex4();
+      if (low < 0xDC00 || low >= 0xE000) error("unpaired surrogate");
+      code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+    } else if (code >= 0xDC00 && code < 0xE000) {
+      error("unpaired surrogate");
+    }
+    return code;
+  }
+
+  unsigned parse_hex4() {
+    const std::string digits = m_text.substr(m_pos, 4);
+    for (const char c : digits) {
+      if (!isxdigit(static_cast<unsigned char>(c))) error("invalid \\u escape");
+    }
+    if (digits.size() != 4) error("invalid \\u escape");
+    m_pos += 4;
+    return std::strtoul(digits.c_str(), nullptr, 16);
+  }
+
+  static void append_utf8(std::string& s, const unsigned code) {
+    if (code < 0x80) {
+      s += static_cast<char>(code);
+    } else if (code < 0x800) {
+      s += static_cast<char>(0xC0 | (code >> 6));
+      s += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+      s += static_cast<char>(0xE0 | (code >> 12));
+      s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      s += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+      s += static_cast<char>(0xF0 | (code >> 18));
+      s += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+      s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+      s += static_cast<char>(0x80 | (code & 0x3F));
+    }
+  }
+
+  bool keyword(const char* word) {
+    const size_t n = strlen(word);
+    if (m_text.compare(m_pos, n, word) != 0) return false;
+    m_pos += n;
+    return true;
+  }
+
+  bool consume(const char c) {
+    skip_space();
+    if (m_pos < m_text.size() && m_text[m_pos] == c) {
+      ++m_pos;
+      return true;
+    }
+    return false;
+  }
+
+  void skip_space() {
+    while (m_pos < m_text.size() &&
+           isspace(static_cast<unsigned char>(m_text[m_pos]))) {
+      ++m_pos;
+    }
+  }
+
+  [[noreturn]] void error(const char* what) const {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::umpire_prewarm ERROR: " + m_source + " at offset " +
+        std::to_string(m_pos) + ": " + what);
+  }
+
+  const std::string& m_text;
+  const std::string& m_source;
+  size_t m_pos = 0;
+};
+
+struct UmpirePoolConfig {
+  std::string name;
+  std::string upstream = "HOST";
+  size_t initial_bytes = 0;
+  size_t grow_bytes    = 0;
+  UmpirePoolStrategy strategy = UmpirePoolStrategy::QuickPool;
+  bool touch = true;
+};
+
+struct UmpirePrewarmConfig {
+  std::vector<std::string> allocators;
+  std::vector<UmpirePoolConfig> pools;
+};
+
+void umpire_read_config_file(const std::string& path,
+                             UmpirePrewarmConfig& config) {
+  std::ifstream file(path);
+  if (!file) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::umpire_prewarm ERROR: cannot read " + path);
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  const UmpireConfigValue root = UmpireConfigParser(text.str(), path).parse();
+
+  auto invalid = [&](const std::string& what) {
+    Kokkos::Impl::throw_runtime_exception("Kokkos::umpire_prewarm ERROR: " +
+                                          path + ": " + what);
+  };
+  auto bytes = [&](const UmpireConfigValue& value, const std::string& what) {
+    const double max_bytes = std::numeric_limits<size_t>::max();
+    if (value.kind == UmpireConfigValue::Kind::Number && value.number >= 0 &&
+        value.number < max_bytes) {
+      return static_cast<size_t>(value.number);
+    }
+    if (value.kind != UmpireConfigValue::Kind::String) {
+      invalid(what + " must be a byte count");
+    }
+    return umpire_parse_bytes(value.string, path + ": " + what);
+  };
+
+  if (root.kind != UmpireConfigValue::Kind::Object) {
+    invalid("expected an object");
+  }
+  auto array = [&](const char* key) -> const UmpireConfigValue* {
+    const auto* value = root.find(key);
+    if (value && value->kind != UmpireConfigValue::Kind::Array) {
+      invalid(std::string(key) + " must be an array");
+    }
+    return value;
+  };
+  auto string = [&](const UmpireConfigValue& value, const std::string& what) {
+    if (value.kind != UmpireConfigValue::Kind::String) {
+      invalid(what + " must be a string");
+    }
+    return value.string;
+  };
+
+  if (const auto* allocators = array("allocators")) {
+    for (const auto& name : allocators->array) {
+      if (name.kind != UmpireConfigValue::Kind::String) {
+        invalid("allocators must be names");
+      }
+      config.allocators.push_back(name.string);
+    }
+  }
+  if (const auto* pools = array("pools")) {
+    for (const auto& entry : pools->array) {
+      if (entry.kind != UmpireConfigValue::Kind::Object) {
+        invalid("pools must be objects");
+      }
+      const auto* name = entry.find("name");
+      const auto* initial = entry.find("initial_bytes");
+      if (!name || name->kind != UmpireConfigValue::Kind::String || !initial) {
+        invalid("pools need a name and initial_bytes");
+      }
+      UmpirePoolConfig pool;
+      pool.name          = name->string;
+      pool.initial_bytes = bytes(*initial, pool.name + " initial_bytes");
+      pool.grow_bytes    = pool.initial_bytes;
+      if (const auto* grow = entry.find("grow_bytes")) {
+        pool.grow_bytes = bytes(*grow, pool.name + " grow_bytes");
+      }
+      if (const auto* upstream = entry.find("upstream")) {
+        pool.upstream = string(*upstream, pool.name + " upstream");
+      }
+      if (const auto* strategy = entry.find("strategy")) {
+        const std::string value = string(*strategy, pool.name + " strategy");
+        if (value == "DynamicPoolList") {
+          pool.strategy = UmpirePoolStrategy::DynamicPoolList;
+        } else if (value != "QuickPool") {
+          invalid(pool.name + ": unknown pool strategy " + value);
+        }
+      }
+      if (const auto* touch = entry.find("touch")) {
+        if (touch->kind != UmpireConfigValue::Kind::Boolean) {
+          invalid(pool.name + " touch must be true or false");
+        }
+        pool.touch = touch->boolean;
+      }
+      config.pools.push_back(pool);
+    }
+  }
+}
+
+/* umpire_read_config_environment - KOKKOS_UMPIRE_ALLOCATORS is a comma
+ * separated list of allocator names, KOKKOS_UMPIRE_POOLS one of host pools
+ * name:initial_bytes[:grow_bytes].
+ */
+void umpire_read_config_environment(UmpirePrewarmConfig& config) {
+  auto split = [](const char* list, const char separator) {
+    std::vector<std::string> items;
+    std::string item;
+    std::stringstream stream(list ? list : "");
+    while (std::getline(stream, item, separator)) {
+      if (!item.empty()) items.push_back(item);
+    }
+    return items;
+  };
+
+  for (const auto& name : split(std::getenv("KOKKOS_UMPIRE_ALLOCATORS"), ',')) {
+    config.allocators.push_back(name);
+  }
+  for (const auto& spec : split(std::getenv("KOKKOS_UMPIRE_POOLS"), ',')) {
+    const auto fields = split(spec.c_str(), ':');
+    if (fields.size() < 2 || fields.size() > 3) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::umpire_prewarm ERROR: KOKKOS_UMPIRE_POOLS: '" + spec +
+          "' is not name:initial_bytes[:grow_bytes]");
+    }
+    const char* what = "KOKKOS_UMPIRE_POOLS";
+    UmpirePoolConfig pool;
+    pool.name          = fields[0];
+    pool.initial_bytes = umpire_parse_bytes(fields[1], what);
+    pool.grow_bytes    = fields.size() == 3
+                          ? umpire_parse_bytes(fields[2], what)
+                          : pool.initial_bytes;
+    config.pools.push_back(pool);
+  }
+}
+
+/* umpire_environment_trace - start the trace KOKKOS_UMPIRE_TRACE asks for,
+ * once per process; a trace that cannot be started throws here, and is
+ * tried again by the next call.
+ */
+void umpire_environment_trace() {
+  static std::once_flag s_once;
+  std::call_once(s_once, umpire_trace_start_from_environment);
+}
+
+/* umpire_prewarm_config - resolve the allocators, then create each pool and
+ * have it acquire its initial block, which is touched (zeroed, in parallel
+ * on the host) and handed back to the pool, so that neither the pool nor
+ * the page faults of the block are left to the first View allocations.
+ */
+void umpire_prewarm_config(const UmpirePrewarmConfig& config) {
+  umpire_default_allocator<Kokkos::HostSpace>();
+#if defined(KOKKOS_ENABLE_CUDA)
+  umpire_default_allocator<Kokkos::CudaSpace>();
+  umpire_default_allocator<Kokkos::CudaUVMSpace>();
+  umpire_default_allocator<Kokkos::CudaHostPinnedSpace>();
+#endif
+
+  for (const auto& name : config.allocators) get_allocator(name.c_str());
+
+  for (const auto& pool : config.pools) {
+    umpire::Allocator allocator = umpire_make_pool(
+        pool.name.c_str(), get_allocator(pool.upstream.c_str()),
+        pool.initial_bytes, pool.grow_bytes, pool.strategy);
+    if (pool.initial_bytes == 0) continue;
+
+    void* const ptr = umpire_allocate(allocator, pool.initial_bytes);
+    if (pool.touch) {
+      if (allocator.getPlatform() == umpire::Platform::host) {
+        umpire_host_fill(ptr, 0, pool.initial_bytes);
+      } else {
+        umpire_memset(ptr, 0, pool.initial_bytes);
+      }
+    }
+    umpire_deallocate(allocator, ptr, pool.initial_bytes);
+  }
+}
+
+}  // namespace
+
+/* umpire_parse_bytes - also used for the configurations of the replay tool
+ *
+ * Only digits with an optional fraction are handed to strtod, which would
+ * otherwise also take whitespace, signs, exponents, hex, inf and nan. */
+size_t umpire_parse_bytes(const std::string& text, const std::string& what) {
+  const size_t digits      = text.find_first_not_of("0123456789.");
+  const std::string number = text.substr(0, digits);
+  double scale             = 1;
+  if (digits != std::string::npos && digits + 1 == text.size()) {
+    switch (toupper(static_cast<unsigned char>(text[digits]))) {
+      case 'K': scale = 1 << 10; break;
+      case 'M': scale = 1 << 20; break;
+      case 'G': scale = 1 << 30; break;
+      default: break;
+    }
+  }
+  const bool valid = !number.empty() && number != "." &&
+                     number.find('.') == number.rfind('.') &&
+                     (digits == std::string::npos || scale != 1);
+  const double bytes = valid ? std::strtod(number.c_str(), nullptr) * scale : 0;
+  // the largest size_t rounds up to 2^64 as a double
+  if (!valid ||
+      !(bytes < static_cast<double>(std::numeric_limits<size_t>::max()))) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::UmpireSpace ERROR: " + what + ": '" + text +
+        "' is not a byte count");
+  }
+  return static_cast<size_t>(bytes);
+}
+
+}  // namespace Impl
+
+void umpire_prewarm() {
+  Impl::umpire_environment_trace();
+  Impl::UmpirePrewarmConfig config;
+  if (const char* path = std::getenv("KOKKOS_UMPIRE_CONFIG")) {
+    if (*path) Impl::umpire_read_config_file(path, config);
+  }
+  Impl::umpire_read_config_environment(config);
+  Impl::umpire_prewarm_config(config);
+}
+
+void umpire_prewarm(const std::string& config_file) {
+  Impl::umpire_environment_trace();
+  Impl::UmpirePrewarmConfig config;
+  Impl::umpire_read_config_file(config_file, config);
+  Impl::umpire_prewarm_config(config);
+}
+
+}  // namespace Kokkos
@@ -0,0 +1,216 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Macros.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "umpire/strategy/AllocationStrategy.hpp"
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+using umpire_pool_event_callback =
+    std::function<void(const UmpirePoolEvent&)>;
+
+std::mutex s_pool_event_mutex;
+std::shared_ptr<umpire_pool_event_callback> s_pool_event_callback;
+
+/* umpire_space_handle - Kokkos Tools space handle for ptr: the allocator
+ * name for pointers into Umpire spaces, Kokkos::HostSpace otherwise.
+ */
+Kokkos::Profiling::SpaceHandle umpire_space_handle(const void* ptr,
+                                                   const bool is_umpire) {
+  if (!is_umpire) return Kokkos::Profiling::SpaceHandle(HostSpace::name());
+
+  auto& rm  = umpire::ResourceManager::getInstance();
+  void* p   = const_cast<void*>(ptr);
+  auto name = std::string(UmpireHostSpace::name());
+  if (rm.hasAllocator(p)) name += ":" + rm.getAllocator(p).getName();
+  return Kokkos::Profiling::SpaceHandle(name.c_str());
+}
+
+/* umpire_deep_copy_label - the label of the View whose data ptr is, from
+ * the host side mirror of its SharedAllocationHeader, "" for any other
+ * pointer.  The header in front of ptr is not read in place: ptr may point
+ * into the middle of an allocation, where it would be user data.
+ */
+std::string umpire_deep_copy_label(const void* ptr, const bool is_umpire) {
+  if (!is_umpire || ptr == nullptr) return "";
+
+  SharedAllocationHeader header;
+  if (!umpire_header_mirror_find(
+          SharedAllocationHeader::get_header(const_cast<void*>(ptr)),
+          header)) {
+    return "";
+  }
+  return header.label();
+}
+
+/* UmpirePoolUpstreamStrategy - sits between a pool made by make_pool and the
+ * allocator it was made on, so that every block the pool acquires (grows by)
+ * or releases is reported to Kokkos Tools and the pool event callback.
+ */
+class UmpirePoolUpstreamStrategy : public umpire::strategy::AllocationStrategy {
+ public:
+  UmpirePoolUpstreamStrategy(const std::string& name, int id,
+                             umpire::Allocator upstream,
+                             const std::string& pool_name)
+      : umpire::strategy::AllocationStrategy(name, id),
+        m_upstream(upstream.getAllocationStrategy()),
+        m_pool_name(pool_name),
+        m_space_name(std::string(UmpireHostSpace::name()) + ":" +
+                     upstream.getName()) {}
+
+  void* allocate(std::size_t bytes) override {
+    void* ptr = m_upstream->allocate(bytes);
+    if (ptr) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_blocks[ptr] = bytes;
+      }
+      report(UmpirePoolEventKind::Grow, ptr, bytes);
+    }
+    return ptr;
+  }
+
+  void deallocate(void* ptr) override {
+    size_t bytes = 0;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      auto it = m_blocks.find(ptr);
+      if (it != m_blocks.end()) {
+        bytes = it->second;
+        m_blocks.erase(it);
+      }
+    }
+    report(UmpirePoolEventKind::Release, ptr, bytes);
+    m_upstream->deallocate(ptr);
+  }
+
+  umpire::Platform getPlatform() noexcept override {
+    return m_upstream->getPlatform();
+  }
+
+ private:
+  void report(const UmpirePoolEventKind kind, void* ptr, const size_t bytes) {
+#if defined(KOKKOS_ENABLE_PROFILING)
+    if (Kokkos::Profiling::profileLibraryLoaded()) {
+      const Kokkos::Profiling::SpaceHandle handle(m_space_name.c_str());
+      if (kind == UmpirePoolEventKind::Grow) {
+        Kokkos::Profiling::allocateData(handle, m_pool_name, ptr, bytes);
+      } else {
+        Kokkos::Profiling::deallocateData(handle, m_pool_name, ptr, bytes);
+      }
+    }
+#endif
+
+    std::shared_ptr<umpire_pool_event_callback> callback;
+    {
+      std::lock_guard<std::mutex> lock(s_pool_event_mutex);
+      callback = s_pool_event_callback;
+    }
+    if (callback) (*callback)({m_pool_name.c_str(), kind, ptr, bytes});
+  }
+
+  umpire::strategy::AllocationStrategy* m_upstream;
+  const std::string m_pool_name;
+  const std::string m_space_name;
+  std::mutex m_mutex;
+  std::unordered_map<void*, size_t> m_blocks;
+};
+
+}  // namespace
+
+void umpire_begin_deep_copy(const void* dst, const bool dst_is_umpire,
+                            const void* src, const bool src_is_umpire,
+                            const size_t n) {
+#if defined(KOKKOS_ENABLE_PROFILING)
+  Kokkos::Profiling::beginDeepCopy(
+      umpire_space_handle(dst, dst_is_umpire),
+      umpire_deep_copy_label(dst, dst_is_umpire), dst,
+      umpire_space_handle(src, src_is_umpire),
+      umpire_deep_copy_label(src, src_is_umpire), src, n);
+#else
+  (void)dst, (void)dst_is_umpire, (void)src, (void)src_is_umpire, (void)n;
+#endif
+}
+
+void umpire_end_deep_copy() {
+#if defined(KOKKOS_ENABLE_PROFILING)
+  Kokkos::Profiling::endDeepCopy();
+#endif
+}
+
+/* umpire_make_pool_upstream - the allocator a pool named pool_name is made
+ * on instead of upstream, reporting the pool's blocks.
+ */
+umpire::Allocator umpire_make_pool_upstream(const char* pool_name,
+                                            umpire::Allocator upstream) {
+  auto& rm = umpire::ResourceManager::getInstance();
+  return rm.makeAllocator<UmpirePoolUpstreamStrategy>(
+      std::string(pool_name) + "::upstream", upstream, pool_name);
+}
+
+}  // namespace Impl
+
+void set_umpire_pool_event_callback(
+    std::function<void(const UmpirePoolEvent&)> callback) {
+  std::lock_guard<std::mutex> lock(Impl::s_pool_event_mutex);
+  Impl::s_pool_event_callback =
+      callback ? std::make_shared<Impl::umpire_pool_event_callback>(
+                     std::move(callback))
+               : nullptr;
+}
+
+}  // namespace Kokkos
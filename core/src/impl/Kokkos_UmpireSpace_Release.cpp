@@ -0,0 +1,249 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Kokkos_Core.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+/* umpire_memory_pressure - the "some avg10" of /proc/pressure/memory: the
+ * percentage of the last 10 s in which some task stalled on memory, or -1
+ * where the kernel does not report it.
+ */
+double umpire_memory_pressure() {
+  double avg10 = -1;
+#if defined(__linux__)
+  if (FILE* file = std::fopen("/proc/pressure/memory", "r")) {
+    if (std::fscanf(file, "some avg10=%lf", &avg10) != 1) avg10 = -1;
+    std::fclose(file);
+  }
+#endif
+  return avg10;
+}
+
+/* umpire_release_target - the allocator holding the memory of allocator: the
+ * one beneath an "<allocator>::thread_safe" wrapper, which does not pass
+ * release on.
+ */
+umpire::Allocator umpire_release_target(umpire::Allocator allocator) {
+  if (!umpire_is_thread_safe(allocator)) return allocator;
+
+  static const std::string suffix = "::thread_safe";
+  const std::string& name         = allocator.getName();
+  auto& rm                        = umpire::ResourceManager::getInstance();
+  if (name.size() > suffix.size() &&
+      !name.compare(name.size() - suffix.size(), suffix.size(), suffix)) {
+    return rm.getAllocator(name.substr(0, name.size() - suffix.size()));
+  }
+  return allocator;
+}
+
+int64_t umpire_now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+/* UmpireReleaser - the release policy of one Umpire allocator.  The free
+ * bytes and memory pressure checks are made by deallocations of its spaces,
+ * so they never race with them (spaces that are not thread safe are not
+ * used concurrently in the first place); the free bytes threshold is re-armed
+ * above what a release leaves behind, so that memory a pool cannot release
+ * does not make every deallocation try again.
+ */
+class UmpireReleaser {
+ public:
+  explicit UmpireReleaser(umpire::Allocator allocator)
+      : m_allocator(allocator) {}
+
+  void set_policy(const UmpireReleasePolicy& policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_policy = policy;
+    m_armed_bytes.store(policy.free_bytes, std::memory_order_relaxed);
+    m_next_poll_ns.store(0, std::memory_order_relaxed);
+  }
+
+  bool at_release_points() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_policy.at_release_points;
+  }
+
+  void check() {
+    const size_t armed = m_armed_bytes.load(std::memory_order_relaxed);
+    if (armed && free_bytes() > armed) release();
+
+    const int64_t next_poll = m_next_poll_ns.load(std::memory_order_relaxed);
+    if (next_poll < 0) return;
+    const int64_t now = umpire_now_ns();
+    if (now < next_poll) return;
+
+    UmpireReleasePolicy policy;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      policy = m_policy;
+    }
+    if (policy.pressure_percent <= 0) {
+      m_next_poll_ns.store(-1, std::memory_order_relaxed);
+      return;
+    }
+    m_next_poll_ns.store(now + int64_t(policy.pressure_interval * 1.0e9),
+                         std::memory_order_relaxed);
+    if (umpire_memory_pressure() > policy.pressure_percent) release();
+  }
+
+  size_t release() {
+    const size_t released = umpire_release(m_allocator);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_policy.free_bytes) {
+      m_armed_bytes.store(free_bytes() + m_policy.free_bytes,
+                          std::memory_order_relaxed);
+    }
+    return released;
+  }
+
+  static UmpireReleaser* get(umpire::Allocator allocator) {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    for (auto releaser : registry()) {
+      if (releaser->m_allocator.getId() == allocator.getId()) return releaser;
+    }
+    registry().push_back(new UmpireReleaser(allocator));
+    return registry().back();
+  }
+
+  static std::vector<UmpireReleaser*> all() {
+    std::lock_guard<std::mutex> lock(registry_mutex());
+    return registry();
+  }
+
+ private:
+  size_t free_bytes() {
+    umpire::Allocator target = umpire_release_target(m_allocator);
+    const size_t actual      = target.getActualSize();
+    const size_t current     = target.getCurrentSize();
+    return actual > current ? actual - current : 0;
+  }
+
+  static std::mutex& registry_mutex() {
+    static std::mutex s_mutex;
+    return s_mutex;
+  }
+
+  static std::vector<UmpireReleaser*>& registry() {
+    static std::vector<UmpireReleaser*> s_releasers;
+    return s_releasers;
+  }
+
+  umpire::Allocator m_allocator;
+  std::mutex m_mutex;
+  UmpireReleasePolicy m_policy;
+  // free bytes above which a deallocation releases, 0 for never
+  std::atomic<size_t> m_armed_bytes{0};
+  // steady clock time of the next memory pressure poll, -1 for never
+  std::atomic<int64_t> m_next_poll_ns{-1};
+};
+
+/* umpire_release - release the free memory of allocator (for pools, the
+ * blocks that are entirely unused) to its upstream allocator.
+ */
+size_t umpire_release(umpire::Allocator allocator) {
+  umpire::Allocator target = umpire_release_target(allocator);
+  const size_t before      = target.getActualSize();
+  target.release();
+  const size_t after = target.getActualSize();
+  return before > after ? before - after : 0;
+}
+
+void umpire_set_release_policy(umpire::Allocator allocator,
+                               UmpireSpaceCounters* counters,
+                               const UmpireReleasePolicy& policy) {
+  if (umpire_is_thread_safe(allocator) &&
+      (policy.free_bytes || policy.pressure_percent > 0)) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::UmpireSpace::set_release_policy ERROR: thread safe spaces "
+        "only release at release points");
+  }
+
+  const bool active = policy.at_release_points || policy.free_bytes ||
+                      policy.pressure_percent > 0;
+  UmpireReleaser* const releaser = UmpireReleaser::get(allocator);
+  releaser->set_policy(policy);
+  counters->releaser.store(active ? releaser : nullptr,
+                           std::memory_order_release);
+
+  // finalize is a release point too
+  static const bool s_hook = [] {
+    Kokkos::push_finalize_hook([] { Kokkos::umpire_release_point(); });
+    return true;
+  }();
+  (void)s_hook;
+}
+
+void umpire_release_check(UmpireReleaser* releaser) { releaser->check(); }
+
+}  // namespace Impl
+
+void umpire_release_point() {
+  for (Impl::UmpireReleaser* releaser : Impl::UmpireReleaser::all()) {
+    if (releaser->at_release_points()) releaser->release();
+  }
+}
+
+}  // namespace Kokkos
@@ -0,0 +1,397 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+#include <impl/Kokkos_UmpireSpace_MappedStrategy.hpp>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/stat.h>
+#endif
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+[[noreturn]] void umpire_shared_failure(const std::string& what) {
+  Kokkos::Impl::throw_runtime_exception("Kokkos::UmpireSpace ERROR: " + what +
+                                        ": " + strerror(errno));
+}
+
+/* umpire_shared_segment_stem - "/<prefix>.<label>:", with the characters
+ * of the label that may not appear in a segment name replaced by '_'.  The
+ * segments of the Views labeled label are named by the stem followed by
+ * "<pid>.<serial>" of the allocation, so that several of them, e.g. the old
+ * and the new View of a resize, can be alive at once.
+ */
+std::string umpire_shared_segment_stem(const std::string& prefix,
+                                       const char* label) {
+  std::string name = "/" + prefix + ".";
+  for (const char* c = label; *c; ++c) {
+    const bool valid = isalnum(static_cast<unsigned char>(*c)) || *c == '_' ||
+                       *c == '-' || *c == '.';
+    name += valid ? *c : '_';
+  }
+  return name + ":";
+}
+
+#if defined(__linux__)
+
+/* UmpireSharedDescriptor - first page of a segment.  magic is written last
+ * (released), once the data of the View in the segment is known.  The
+ * generation orders the segments of Views with the same label by creation,
+ * node wide.
+ */
+struct UmpireSharedDescriptor {
+  static constexpr uint64_t published = 0x4b6f6b6b6f73534dull;
+
+  std::atomic<uint64_t> magic;
+  uint64_t generation;
+  uint64_t data_offset;
+  uint64_t data_bytes;
+};
+
+/* umpire_shared_generation - CLOCK_MONOTONIC in ns, which all processes on
+ * the node share
+ */
+uint64_t umpire_shared_generation() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+}
+
+/* umpire_shared_newest_segment - the published segment of the highest
+ * generation among those named by stem, or "" if there is none.  POSIX
+ * shared memory segments are the files in /dev/shm on Linux.
+ */
+std::string umpire_shared_newest_segment(const std::string& stem) {
+  std::string newest;
+  uint64_t newest_generation = 0;
+
+  DIR* const dir = opendir("/dev/shm");
+  if (dir == nullptr) return newest;
+  const std::string file = stem.substr(1);
+  while (const dirent* entry = readdir(dir)) {
+    if (strncmp(entry->d_name, file.c_str(), file.size())) continue;
+
+    // segments may go away, or not be sized yet, while we look
+    const std::string segment = std::string("/") + entry->d_name;
+    const int fd              = shm_open(segment.c_str(), O_RDONLY, 0);
+    if (fd < 0) continue;
+    struct stat status;
+    void* base = MAP_FAILED;
+    if (fstat(fd, &status) == 0 &&
+        size_t(status.st_size) >= sizeof(UmpireSharedDescriptor)) {
+      base = mmap(nullptr, sizeof(UmpireSharedDescriptor), PROT_READ,
+                  MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) continue;
+
+    const auto* const descriptor = static_cast<UmpireSharedDescriptor*>(base);
+    if (descriptor->magic.load(std::memory_order_acquire) ==
+            UmpireSharedDescriptor::published &&
+        (newest.empty() || descriptor->generation > newest_generation)) {
+      newest            = segment;
+      newest_generation = descriptor->generation;
+    }
+    munmap(base, sizeof(UmpireSharedDescriptor));
+  }
+  closedir(dir);
+  return newest;
+}
+
+/* UmpireSharedStrategy - host allocation strategy that puts every request
+ * into a POSIX shared memory segment of its own, named after the label of
+ * the allocation (see UmpireNamedAllocation) and preceded by a page with
+ * the UmpireSharedDescriptor.  The segment is unlinked on deallocation.
+ */
+class UmpireSharedStrategy : public UmpireMappedStrategy {
+ public:
+  UmpireSharedStrategy(const std::string& name, int id,
+                       umpire::Allocator fallback, const std::string& prefix)
+      : UmpireMappedStrategy(name, id, fallback, 0, system_page_bytes()),
+        m_prefix(prefix) {}
+
+  const std::string& prefix() const { return m_prefix; }
+
+ protected:
+  void* map_pages(const size_t size) override {
+    UmpireNamedAllocation* const named = UmpireNamedAllocation::current();
+    if (!named || !named->name() || !*named->name()) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace ERROR: allocations in node shared memory need "
+          "a label");
+    }
+
+    static std::atomic<uint64_t> s_serial{0};
+    const std::string segment =
+        umpire_shared_segment_stem(m_prefix, named->name()) +
+        std::to_string(getpid()) + "." +
+        std::to_string(s_serial.fetch_add(1, std::memory_order_relaxed));
+    const int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+      umpire_shared_failure("cannot create shared memory segment " + segment);
+    }
+
+    const size_t page = system_page_bytes();
+    void* base        = MAP_FAILED;
+    if (ftruncate(fd, page + size) == 0) {
+      base = mmap(nullptr, page + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                  0);
+    }
+    const int error = errno;
+    close(fd);
+    if (base == MAP_FAILED) {
+      shm_unlink(segment.c_str());
+      errno = error;
+      umpire_shared_failure("cannot map shared memory segment " + segment);
+    }
+
+    static_cast<UmpireSharedDescriptor*>(base)->generation =
+        umpire_shared_generation();
+    named->segment = base;
+    {
+      std::lock_guard<std::mutex> lock(m_segments_mutex);
+      m_segments[base] = segment;
+    }
+    return static_cast<char*>(base) + page;
+  }
+
+  void unmap_pages(void* ptr, const size_t size) override {
+    const size_t page = system_page_bytes();
+    void* const base  = static_cast<char*>(ptr) - page;
+
+    std::string segment;
+    {
+      std::lock_guard<std::mutex> lock(m_segments_mutex);
+      auto it = m_segments.find(base);
+      segment = std::move(it->second);
+      m_segments.erase(it);
+    }
+    // attached processes keep their mappings of the segment
+    shm_unlink(segment.c_str());
+    munmap(base, page + size);
+  }
+
+ private:
+  const std::string m_prefix;
+  std::mutex m_segments_mutex;
+  std::unordered_map<void*, std::string> m_segments;
+};
+
+/* mappings made by umpire_shared_attach in this process, by data pointer */
+struct UmpireSharedAttachment {
+  void* base;
+  size_t size;
+};
+
+std::mutex& umpire_shared_attachments_mutex() {
+  static std::mutex s_mutex;
+  return s_mutex;
+}
+
+std::unordered_map<const void*, UmpireSharedAttachment>&
+umpire_shared_attachments() {
+  static std::unordered_map<const void*, UmpireSharedAttachment> s_map;
+  return s_map;
+}
+
+#endif
+
+}  // namespace
+
+std::string umpire_shared_allocator_name(const char* prefix) {
+  std::string name = umpire_shared_prefix;
+  if (prefix && *prefix) name += std::string(":") + prefix;
+  return name;
+}
+
+bool umpire_make_shared_allocator(const char* name) {
+  const size_t length = strlen(umpire_shared_prefix);
+  if (strncmp(name, umpire_shared_prefix, length) ||
+      (name[length] != '\0' && name[length] != ':')) {
+    return false;
+  }
+
+#if defined(__linux__)
+  const std::string prefix =
+      name[length] ? name + length + 1 : umpire_shared_default_prefix;
+
+  auto& rm = umpire::ResourceManager::getInstance();
+  rm.makeAllocator<UmpireSharedStrategy>(
+      name, umpire_host_aligned_allocator(), prefix);
+  return true;
+#else
+  Kokkos::Impl::throw_runtime_exception(
+      std::string("Kokkos::UmpireSpace ERROR: ") + name +
+      " allocators are only available on Linux");
+#endif
+}
+
+/* umpire_shared_publish - record where in the segment the data of the View
+ * is, so that other processes can attach to it.
+ */
+void umpire_shared_publish(void* segment, const void* data,
+                           const size_t bytes) {
+#if defined(__linux__)
+  auto* const descriptor = static_cast<UmpireSharedDescriptor*>(segment);
+  descriptor->data_offset =
+      static_cast<const char*>(data) - static_cast<char*>(segment);
+  descriptor->data_bytes = bytes;
+  descriptor->magic.store(UmpireSharedDescriptor::published,
+                          std::memory_order_release);
+#else
+  (void)segment;
+  (void)data;
+  (void)bytes;
+#endif
+}
+
+/* umpire_shared_attach - map the segment of the newest View labeled label
+ * of the node shared allocator, read only if asked to, and return its data
+ * and size in bytes.
+ */
+void* umpire_shared_attach(umpire::Allocator allocator, const char* label,
+                           const bool read_only, size_t& bytes) {
+#if defined(__linux__)
+  auto* const strategy =
+      dynamic_cast<UmpireSharedStrategy*>(allocator.getAllocationStrategy());
+  if (strategy == nullptr) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::UmpireSpace ERROR: umpire_attach_shared needs a node shared "
+        "space");
+  }
+
+  const std::string segment = umpire_shared_newest_segment(
+      umpire_shared_segment_stem(strategy->prefix(), label));
+  if (segment.empty()) {
+    errno = ENOENT;
+    umpire_shared_failure(std::string("no shared memory segment holds View ") +
+                          label);
+  }
+  const int fd = shm_open(segment.c_str(), read_only ? O_RDONLY : O_RDWR, 0);
+  if (fd < 0) {
+    umpire_shared_failure("cannot open shared memory segment " + segment);
+  }
+
+  struct stat status;
+  void* base = MAP_FAILED;
+  if (fstat(fd, &status) == 0) {
+    base = mmap(nullptr, status.st_size,
+                read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                0);
+  }
+  const int error = errno;
+  close(fd);
+  if (base == MAP_FAILED) {
+    errno = error;
+    umpire_shared_failure("cannot map shared memory segment " + segment);
+  }
+
+  const auto* const descriptor = static_cast<UmpireSharedDescriptor*>(base);
+  if (descriptor->magic.load(std::memory_order_acquire) !=
+      UmpireSharedDescriptor::published) {
+    munmap(base, status.st_size);
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::UmpireSpace ERROR: shared memory segment " + segment +
+        " holds no View yet");
+  }
+
+  void* const data = static_cast<char*>(base) + descriptor->data_offset;
+  bytes            = descriptor->data_bytes;
+
+  std::lock_guard<std::mutex> lock(umpire_shared_attachments_mutex());
+  umpire_shared_attachments()[data] = {base, size_t(status.st_size)};
+  return data;
+#else
+  (void)allocator;
+  (void)label;
+  (void)read_only;
+  (void)bytes;
+  Kokkos::Impl::throw_runtime_exception(
+      "Kokkos::UmpireSpace ERROR: node shared memory is only available on "
+      "Linux");
+#endif
+}
+
+void umpire_shared_detach(const void* data) {
+#if defined(__linux__)
+  UmpireSharedAttachment attachment;
+  {
+    std::lock_guard<std::mutex> lock(umpire_shared_attachments_mutex());
+    auto it = umpire_shared_attachments().find(data);
+    if (it == umpire_shared_attachments().end()) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace ERROR: umpire_detach_shared of a View that "
+          "was not attached");
+    }
+    attachment = it->second;
+    umpire_shared_attachments().erase(it);
+  }
+  munmap(attachment.base, attachment.size);
+#else
+  (void)data;
+#endif
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,186 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+#include <umpire/strategy/FixedPool.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+/* UmpireSizeClasses - segregated Umpire FixedPools for small objects, one
+ *                     per power of two size class from 64 B up to max_bytes.
+ *
+ * A request is rounded up to its class and served by that class's
+ * FixedPool; a deallocation, whose size Kokkos always passes along, goes
+ * back to the pool of the same class, so no lookup over the pools is
+ * needed.  The FixedPools take their chunks from one QuickPool on the
+ * upstream allocator, whose blocks are aligned to umpire_pool_alignment;
+ * all classes being multiples of it, every object is aligned as well.
+ *
+ * The pools are named "<upstream>::size_class_<bytes>" and shared by all
+ * size classes made on the same upstream allocator, whatever their
+ * max_bytes.  Like Umpire allocators they live until the end of the
+ * process.
+ *
+ * On a thread safe upstream (see umpire_make_thread_safe) the chunk pool
+ * and every FixedPool are wrapped in a ThreadSafeAllocator of their own, so
+ * threads only contend when they allocate from the same size class.
+ */
+class UmpireSizeClasses {
+ public:
+  enum : size_t {
+    min_class_bytes = umpire_size_class_min_bytes,
+    chunk_bytes     = 256 * 1024,
+    min_objects     = 64,
+    max_classes     = 16
+  };
+
+  UmpireSizeClasses(umpire::Allocator upstream, const size_t max_bytes)
+      : m_upstream_id(upstream.getId()), m_max_bytes(max_bytes) {
+    auto& rm               = umpire::ResourceManager::getInstance();
+    const std::string base = upstream.getName();
+
+    umpire::Allocator chunks =
+        umpire_make_pool((base + "::size_classes").c_str(), upstream,
+                         4 * chunk_bytes, chunk_bytes,
+                         UmpirePoolStrategy::QuickPool);
+    const bool thread_safe = umpire_is_thread_safe(upstream);
+    if (thread_safe) chunks = umpire_make_thread_safe(chunks);
+
+    for (size_t bytes = min_class_bytes; bytes <= max_bytes; bytes <<= 1) {
+      const std::string name = base + "::size_class_" + std::to_string(bytes);
+      umpire::Allocator pool =
+          rm.isAllocator(name)
+              ? rm.getAllocator(name)
+              : rm.makeAllocator<umpire::strategy::FixedPool>(
+                    name, chunks, bytes, objects(bytes));
+      m_pools.push_back(thread_safe ? umpire_make_thread_safe(pool) : pool);
+    }
+  }
+
+  void* allocate(const size_t n) {
+    const size_t c = size_class(n);
+    return umpire_allocate(m_pools[c], class_bytes(c));
+  }
+
+  void deallocate(void* const ptr, const size_t n) {
+    umpire_deallocate(m_pools[size_class(n)], ptr, class_bytes(size_class(n)));
+  }
+
+  static UmpireSizeClasses* get(umpire::Allocator upstream,
+                                const size_t max_bytes) {
+    static std::mutex s_mutex;
+    static std::vector<UmpireSizeClasses*> s_classes;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto classes : s_classes) {
+      if (classes->m_upstream_id == upstream.getId() &&
+          classes->m_max_bytes == max_bytes) {
+        return classes;
+      }
+    }
+
+    s_classes.push_back(new UmpireSizeClasses(upstream, max_bytes));
+    return s_classes.back();
+  }
+
+ private:
+  static size_t size_class(const size_t n) {
+    size_t c = 0;
+    for (size_t bytes = min_class_bytes; bytes < n; bytes <<= 1) ++c;
+    return c;
+  }
+
+  static size_t class_bytes(const size_t c) {
+    return size_t(min_class_bytes) << c;
+  }
+
+  // objects per FixedPool chunk, about chunk_bytes worth
+  static size_t objects(const size_t bytes) {
+    return std::max<size_t>(chunk_bytes / bytes, min_objects);
+  }
+
+  const int m_upstream_id;
+  const size_t m_max_bytes;
+  std::vector<umpire::Allocator> m_pools;
+};
+
+UmpireSizeClasses* umpire_size_classes(umpire::Allocator upstream,
+                                       const size_t max_bytes) {
+  if (!Kokkos::Impl::is_integral_power_of_two(max_bytes) ||
+      max_bytes < umpire_size_class_min_bytes ||
+      max_bytes > (umpire_size_class_min_bytes
+                   << (UmpireSizeClasses::max_classes - 1))) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::UmpireSpace::make_size_classes ERROR: max_bytes must be a "
+        "power of two between 64 B and 2 MiB");
+  }
+  return UmpireSizeClasses::get(upstream, max_bytes);
+}
+
+void* umpire_size_class_allocate(UmpireSizeClasses* classes,
+                                 const size_t arg_alloc_size) {
+  return classes->allocate(arg_alloc_size);
+}
+
+void umpire_size_class_deallocate(UmpireSizeClasses* classes,
+                                  void* const arg_alloc_ptr,
+                                  const size_t arg_alloc_size) {
+  classes->deallocate(arg_alloc_ptr, arg_alloc_size);
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
@@ -0,0 +1,140 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+/* UmpireSpaceCountersRegistry - the counters of every Umpire allocator a
+ * space was made from, keyed by allocator id.  Counters are never removed,
+ * so spaces can keep plain pointers to them.
+ */
+class UmpireSpaceCountersRegistry {
+ public:
+  UmpireSpaceCounters* get(const umpire::Allocator& allocator) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& counters = m_counters[allocator.getId()];
+    if (!counters) {
+      counters.reset(new UmpireSpaceCounters(allocator.getName()));
+    }
+    return counters.get();
+  }
+
+  std::vector<UmpireSpaceStatistics> statistics() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<UmpireSpaceStatistics> result;
+    for (const auto& counters : m_counters) {
+      result.push_back(counters.second->statistics());
+    }
+    return result;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::map<int, std::unique_ptr<UmpireSpaceCounters>> m_counters;
+};
+
+UmpireSpaceCountersRegistry& umpire_space_counters_registry() {
+  static UmpireSpaceCountersRegistry s_registry;
+
+  // on request, dump the statistics when Kokkos is finalized
+  static const bool s_dump = [] {
+    const char* env = std::getenv("KOKKOS_UMPIRE_STATISTICS");
+    const bool dump = env && std::atoi(env) != 0;
+    if (dump) {
+      Kokkos::push_finalize_hook(
+          [] { Kokkos::print_umpire_space_statistics(std::cout); });
+    }
+    return dump;
+  }();
+  (void)s_dump;
+
+  return s_registry;
+}
+
+}  // namespace
+
+UmpireSpaceStatistics UmpireSpaceCounters::statistics() const {
+  UmpireSpaceStatistics result;
+  result.allocator_name = allocator_name;
+  result.current_bytes  = current_bytes.load(std::memory_order_relaxed);
+  result.peak_bytes     = peak_bytes.load(std::memory_order_relaxed);
+  result.allocations    = allocations.load(std::memory_order_relaxed);
+  result.deallocations  = deallocations.load(std::memory_order_relaxed);
+  result.overhead_bytes = overhead_bytes.load(std::memory_order_relaxed);
+  return result;
+}
+
+UmpireSpaceCounters* umpire_space_counters(const umpire::Allocator& allocator) {
+  return umpire_space_counters_registry().get(allocator);
+}
+
+}  // namespace Impl
+
+std::vector<UmpireSpaceStatistics> umpire_space_statistics() {
+  return Impl::umpire_space_counters_registry().statistics();
+}
+
+void print_umpire_space_statistics(std::ostream& s) {
+  s << "UmpireSpace statistics:" << std::endl;
+  for (const UmpireSpaceStatistics& stats : umpire_space_statistics()) {
+    s << "  " << stats.allocator_name << ": current " << stats.current_bytes
+      << " B, peak " << stats.peak_bytes << " B, allocations "
+      << stats.allocations << ", deallocations " << stats.deallocations
+      << ", overhead " << stats.overhead_bytes << " B" << std::endl;
+  }
+}
+
+}  // namespace Kokkos
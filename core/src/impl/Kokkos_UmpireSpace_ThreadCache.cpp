@@ -0,0 +1,263 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <Kokkos_Macros.hpp>
+#include <impl/Kokkos_Error.hpp>
+#include <Kokkos_UmpireSpace.hpp>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+/* UmpireThreadCache - per-thread free lists of small objects in front of an
+ *                     Umpire allocator, in the style of tcmalloc.
+ *
+ * Requests up to umpire_thread_cache_max_bytes are rounded up to a power of
+ * two size class (64 B .. 4 KiB) and served from a thread local free list
+ * without any locking.  Thread lists are refilled from, and drained to, a
+ * central free list per size class in batches of batch_bytes, so the central
+ * lists and the upstream allocator are only touched once per batch.  The
+ * central lists are refilled by carving slabs obtained from the upstream
+ * Umpire allocator.
+ *
+ * Objects are not returned to the upstream allocator; like Umpire allocators
+ * the caches live until the end of the process.
+ */
+class UmpireThreadCache {
+ public:
+  enum : size_t {
+    min_class_bytes = 64,
+    num_classes     = 7,
+    batch_bytes     = 16 * 1024,
+    slab_bytes      = 256 * 1024,
+    max_caches      = 16
+  };
+
+  static_assert(umpire_thread_cache_min_bytes == min_class_bytes &&
+                    umpire_thread_cache_max_bytes ==
+                        size_t(min_class_bytes) << (num_classes - 1),
+                "umpire_thread_cache_{min,max}_bytes must match the classes");
+
+  UmpireThreadCache(const umpire::Allocator& upstream, size_t index)
+      : m_upstream(upstream), m_index(index) {}
+
+  void* allocate(size_t n) {
+    const size_t c   = size_class(n);
+    ThreadList& list = thread_lists().lists[m_index][c];
+
+    if (list.head == nullptr) refill(c, list);
+
+    void* const ptr = list.head;
+    list.head       = next(ptr);
+    --list.count;
+    return ptr;
+  }
+
+  void deallocate(void* ptr, size_t n) {
+    const size_t c   = size_class(n);
+    ThreadList& list = thread_lists().lists[m_index][c];
+
+    next(ptr) = list.head;
+    list.head = ptr;
+    ++list.count;
+
+    if (list.count >= 2 * batch_count(c)) drain(c, list, batch_count(c));
+  }
+
+  static UmpireThreadCache* get(umpire::Allocator allocator) {
+    static std::mutex s_mutex;
+    static std::vector<UmpireThreadCache*> s_caches;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    for (auto cache : s_caches) {
+      if (cache->m_upstream.getId() == allocator.getId()) return cache;
+    }
+
+    if (s_caches.size() == max_caches) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::UmpireSpace::make_thread_cache ERROR: too many thread "
+          "cached Umpire allocators");
+    }
+
+    s_caches.push_back(new UmpireThreadCache(allocator, s_caches.size()));
+    all_caches()[s_caches.size() - 1] = s_caches.back();
+    return s_caches.back();
+  }
+
+ private:
+  struct ThreadList {
+    void* head   = nullptr;
+    size_t count = 0;
+  };
+
+  struct Batch {
+    void* head;
+    size_t count;
+  };
+
+  // The thread lists of all caches, handed back to the central lists when
+  // the thread exits.
+  struct ThreadLists {
+    ThreadList lists[max_caches][num_classes];
+
+    ~ThreadLists() {
+      for (size_t i = 0; i < max_caches; ++i) {
+        for (size_t c = 0; c < num_classes; ++c) {
+          // only caches this thread has used can have objects in its lists
+          if (lists[i][c].count) {
+            all_caches()[i]->drain(c, lists[i][c], lists[i][c].count);
+          }
+        }
+      }
+    }
+  };
+
+  static ThreadLists& thread_lists() {
+    static thread_local ThreadLists t_lists;
+    return t_lists;
+  }
+
+  static UmpireThreadCache** all_caches() {
+    static UmpireThreadCache* s_all[max_caches] = {};
+    return s_all;
+  }
+
+  static void*& next(void* ptr) { return *reinterpret_cast<void**>(ptr); }
+
+  static size_t size_class(size_t n) {
+    size_t c = 0;
+    for (size_t bytes = min_class_bytes; bytes < n; bytes <<= 1) ++c;
+    return c;
+  }
+
+  static size_t class_bytes(size_t c) { return size_t(min_class_bytes) << c; }
+
+  static size_t batch_count(size_t c) {
+    return std::max<size_t>(batch_bytes / class_bytes(c), 4);
+  }
+
+  // move count objects from the front of the thread list to the central list
+  void drain(size_t c, ThreadList& list, size_t count) {
+    Batch batch{list.head, count};
+
+    void* last = list.head;
+    for (size_t i = 1; i < count; ++i) last = next(last);
+    list.head = next(last);
+    list.count -= count;
+    next(last) = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_central_mutex[c]);
+    m_central[c].push_back(batch);
+  }
+
+  // hand one batch from the central list to the thread list, carving a new
+  // slab into batches first if the central list is empty
+  void refill(size_t c, ThreadList& list) {
+    std::lock_guard<std::mutex> lock(m_central_mutex[c]);
+
+    if (m_central[c].empty()) carve_slab(c);
+
+    list.head  = m_central[c].back().head;
+    list.count = m_central[c].back().count;
+    m_central[c].pop_back();
+  }
+
+  void carve_slab(size_t c) {
+    const size_t bytes = class_bytes(c);
+    char* slab;
+    {
+      std::lock_guard<std::mutex> lock(m_upstream_mutex);
+      slab = static_cast<char*>(
+          umpire_allocate(m_upstream, slab_bytes + min_class_bytes));
+    }
+    // all classes are multiples of min_class_bytes, so aligning the slab
+    // aligns every object carved from it
+    slab += (min_class_bytes -
+             reinterpret_cast<uintptr_t>(slab) % min_class_bytes) %
+            min_class_bytes;
+
+    const size_t objects = slab_bytes / bytes;
+    const size_t batch   = batch_count(c);
+
+    for (size_t first = 0; first < objects; first += batch) {
+      const size_t count = std::min(batch, objects - first);
+      for (size_t i = first; i < first + count; ++i) {
+        next(slab + i * bytes) =
+            i + 1 < first + count ? slab + (i + 1) * bytes : nullptr;
+      }
+      m_central[c].push_back(Batch{slab + first * bytes, count});
+    }
+  }
+
+  umpire::Allocator m_upstream;
+  const size_t m_index;
+  std::mutex m_upstream_mutex;
+  std::mutex m_central_mutex[num_classes];
+  std::vector<Batch> m_central[num_classes];
+};
+
+UmpireThreadCache* umpire_thread_cache(umpire::Allocator allocator) {
+  return UmpireThreadCache::get(allocator);
+}
+
+void* umpire_thread_cache_allocate(UmpireThreadCache* cache,
+                                   const size_t arg_alloc_size) {
+  return cache->allocate(arg_alloc_size);
+}
+
+void umpire_thread_cache_deallocate(UmpireThreadCache* cache,
+                                    void* const arg_alloc_ptr,
+                                    const size_t arg_alloc_size) {
+  cache->deallocate(arg_alloc_ptr, arg_alloc_size);
+}
+
+}  // namespace Impl
+}  // namespace Kokkos
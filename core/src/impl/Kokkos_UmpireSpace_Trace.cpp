@@ -0,0 +1,314 @@
+/*
+//@HEADER
+// ************************************************************************
+//
+//                        Kokkos v. 2.0
+//              Copyright (2014) Sandia Corporation
+//
+// Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+// the U.S. Government retains certain rights in this software.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+// 1. Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright
+// notice, this list of conditions and the following disclaimer in the
+// documentation and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the Corporation nor the names of the
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY SANDIA CORPORATION "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL SANDIA CORPORATION OR THE
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Questions? Contact Christian R. Trott (crtrott@sandia.gov)
+//
+// ************************************************************************
+//@HEADER
+*/
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_UmpireSpace_Trace.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+namespace Kokkos {
+
+namespace Impl {
+
+namespace {
+
+using Kokkos::Experimental::UmpireTraceKind;
+using Kokkos::Experimental::UmpireTraceRecord;
+
+/* UmpireTraceWriter - writes the UmpireSpace trace (see umpire_trace_start).
+ *
+ * Threads append records to buffers of their own and only take the writer
+ * lock to write out a full buffer, or to give a label or allocator seen for
+ * the first time an id; each thread remembers the ids it has used, so the
+ * lock is rare once the labels of a run are known.  Name records are
+ * written right away, so they precede the records using them.
+ *
+ * Each buffer has a lock of its own, which only stop contends for when it
+ * writes out the buffers of all threads.  Locks are taken in the order
+ * buffer set, buffer, writer.
+ */
+class UmpireTraceWriter {
+ public:
+  enum : size_t { buffer_records = 4096 };
+
+  struct ThreadBuffer {
+    ThreadBuffer();
+    ~ThreadBuffer();
+
+    std::mutex mutex;
+    uint32_t thread;
+    // trace the ids and records below belong to
+    uint64_t generation = 0;
+    std::vector<UmpireTraceRecord> records;
+    std::unordered_map<std::string, uint32_t> names;
+  };
+
+  static UmpireTraceWriter& get() {
+    static UmpireTraceWriter s_writer;
+    return s_writer;
+  }
+
+  void start(const std::string& file_name) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::Experimental::umpire_trace_start ERROR: already tracing");
+    }
+    m_file = std::fopen(file_name.c_str(), "wb");
+    if (!m_file) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::Experimental::umpire_trace_start ERROR: cannot create " +
+          file_name);
+    }
+    const Kokkos::Experimental::UmpireTraceFileHeader header;
+    std::fwrite(&header, sizeof(header), 1, m_file);
+
+    m_names.clear();
+    m_start_ns.store(now_ns(), std::memory_order_relaxed);
+    // publishes m_start_ns to the threads recording
+    m_generation.fetch_add(1, std::memory_order_release);
+    umpire_trace_active.store(true, std::memory_order_release);
+  }
+
+  void stop() {
+    umpire_trace_active.store(false, std::memory_order_release);
+
+    // threads that saw the trace active may still be recording
+    std::lock_guard<std::mutex> buffers_lock(m_buffers_mutex);
+    for (ThreadBuffer* buffer : m_buffers) {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (buffer->generation == m_generation.load(std::memory_order_relaxed)) {
+        write_locked(*buffer);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) return;
+    std::fclose(m_file);
+    m_file = nullptr;
+  }
+
+  void record(UmpireTraceRecord record, const char* label,
+              const umpire::Allocator* allocator) {
+    ThreadBuffer& buffer = thread_buffer();
+    std::lock_guard<std::mutex> buffer_lock(buffer.mutex);
+    const uint64_t generation = m_generation.load(std::memory_order_acquire);
+    if (buffer.generation != generation) {
+      // left over from an earlier trace
+      buffer.generation = generation;
+      buffer.records.clear();
+      buffer.names.clear();
+    }
+
+    record.thread  = buffer.thread;
+    record.time_ns = now_ns() - m_start_ns.load(std::memory_order_relaxed);
+    if (label && *label) record.label = name_id(buffer, label);
+    if (allocator) record.allocator = name_id(buffer, allocator->getName());
+
+    buffer.records.push_back(record);
+    if (buffer.records.size() == buffer_records) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      write_locked(buffer);
+    }
+  }
+
+  void add(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> buffers_lock(m_buffers_mutex);
+    buffer->thread = m_threads++;
+    m_buffers.insert(buffer);
+  }
+
+  void remove(ThreadBuffer* buffer) {
+    std::lock_guard<std::mutex> buffers_lock(m_buffers_mutex);
+    {
+      std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (buffer->generation == m_generation.load(std::memory_order_relaxed)) {
+        write_locked(*buffer);
+      }
+    }
+    m_buffers.erase(buffer);
+  }
+
+ private:
+  static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static ThreadBuffer& thread_buffer() {
+    static thread_local ThreadBuffer t_buffer;
+    return t_buffer;
+  }
+
+  uint32_t name_id(ThreadBuffer& buffer, const std::string& name) {
+    auto it = buffer.names.find(name);
+    if (it != buffer.names.end()) return it->second;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& id = m_names[name];
+    if (id == 0) {
+      id = m_names.size();
+      if (m_file) {
+        UmpireTraceRecord record = {};
+        record.kind              = UmpireTraceKind::Name;
+        record.label             = id;
+        record.bytes             = name.size();
+        std::fwrite(&record, sizeof(record), 1, m_file);
+        std::fwrite(name.data(), 1, name.size(), m_file);
+      }
+    }
+    buffer.names.emplace(name, id);
+    return id;
+  }
+
+  void write_locked(ThreadBuffer& buffer) {
+    if (m_file && !buffer.records.empty()) {
+      std::fwrite(buffer.records.data(), sizeof(UmpireTraceRecord),
+                  buffer.records.size(), m_file);
+    }
+    buffer.records.clear();
+  }
+
+  std::mutex m_mutex;
+  FILE* m_file = nullptr;
+  std::atomic<int64_t> m_start_ns{0};
+  std::atomic<uint64_t> m_generation{0};
+  std::unordered_map<std::string, uint32_t> m_names;
+  // guards the set of buffers and the thread count
+  std::mutex m_buffers_mutex;
+  std::unordered_set<ThreadBuffer*> m_buffers;
+  uint32_t m_threads = 0;
+};
+
+UmpireTraceWriter::ThreadBuffer::ThreadBuffer() {
+  records.reserve(buffer_records);
+  UmpireTraceWriter::get().add(this);
+}
+
+UmpireTraceWriter::ThreadBuffer::~ThreadBuffer() {
+  UmpireTraceWriter::get().remove(this);
+}
+
+UmpireTraceRecord umpire_trace_record(const UmpireTraceKind kind,
+                                      const void* ptr, const size_t bytes) {
+  UmpireTraceRecord record = {};
+  record.kind              = kind;
+  record.ptr               = reinterpret_cast<uintptr_t>(ptr);
+  record.bytes             = bytes;
+  return record;
+}
+
+/* the View label of an allocation made by a SharedAllocationRecord */
+const char* umpire_trace_label() {
+  const UmpireNamedAllocation* const named = UmpireNamedAllocation::current();
+  return named ? named->name() : nullptr;
+}
+
+}  // namespace
+
+void umpire_trace_allocate(const umpire::Allocator& allocator, const void* ptr,
+                           const size_t bytes) {
+  UmpireTraceWriter::get().record(
+      umpire_trace_record(UmpireTraceKind::Allocate, ptr, bytes),
+      umpire_trace_label(), &allocator);
+}
+
+void umpire_trace_deallocate(const umpire::Allocator& allocator,
+                             const void* ptr, const size_t bytes) {
+  UmpireTraceWriter::get().record(
+      umpire_trace_record(UmpireTraceKind::Deallocate, ptr, bytes), nullptr,
+      &allocator);
+}
+
+void umpire_trace_reallocate(const umpire::Allocator& allocator,
+                             const void* old_ptr, const void* ptr,
+                             const size_t old_size, const size_t new_size) {
+  UmpireTraceRecord record =
+      umpire_trace_record(UmpireTraceKind::Reallocate, old_ptr, new_size);
+  record.other_ptr = reinterpret_cast<uintptr_t>(ptr);
+  record.old_bytes = old_size;
+  UmpireTraceWriter::get().record(record, nullptr, &allocator);
+}
+
+void umpire_trace_copy(const void* dst, const void* src, const size_t n) {
+  UmpireTraceRecord record = umpire_trace_record(UmpireTraceKind::Copy, dst, n);
+  record.other_ptr = reinterpret_cast<uintptr_t>(src);
+  UmpireTraceWriter::get().record(record, nullptr, nullptr);
+}
+
+/* umpire_trace_start_from_environment - trace to the file named by
+ * KOKKOS_UMPIRE_TRACE, if set, until Kokkos is finalized
+ */
+void umpire_trace_start_from_environment() {
+  const char* file_name = std::getenv("KOKKOS_UMPIRE_TRACE");
+  if (!file_name || !*file_name) return;
+  Kokkos::Experimental::umpire_trace_start(file_name);
+  Kokkos::push_finalize_hook([] { Kokkos::Experimental::umpire_trace_stop(); });
+}
+
+}  // namespace Impl
+
+namespace Experimental {
+
+void umpire_trace_start(const std::string& file_name) {
+  Impl::UmpireTraceWriter::get().start(file_name);
+}
+
+void umpire_trace_stop() { Impl::UmpireTraceWriter::get().stop(); }
+
+}  // namespace Experimental
+}  // namespace Kokkos
@@ -1,5 +1,21 @@
 
 
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <Kokkos_UmpireSpace_DeepCopyBatch.hpp>
+#include <Kokkos_UmpireSpace_Fill.hpp>
+#include <Kokkos_UmpireSpace_Shared.hpp>
+#include <Kokkos_UmpireSpace_Trace.hpp>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace Test {
 
 template <class T>
@@ -64,11 +80,1030 @@ struct TestUmpireAllocators {
     }
     // pooled allocator
     //
+    mem_space_host pool_host = mem_space_host::make_pool(
+        "umpire_test_host_pool", N * sizeof(T), N * sizeof(T));
+    mem_space_host pool_list_host = mem_space_host::make_pool(
+        "umpire_test_host_pool_list", N * sizeof(T), N * sizeof(T),
+        Kokkos::UmpirePoolStrategy::DynamicPoolList);
+    mem_space_device pool_device = mem_space_device::make_pool(
+        "umpire_test_device_pool", N * sizeof(T), N * sizeof(T));
+
+    // asking for an existing pool by name hands back the same pool
+    mem_space_host pool_host_again = mem_space_host::make_pool(
+        "umpire_test_host_pool", N * sizeof(T), N * sizeof(T));
+    ASSERT_EQ(pool_host.get_allocator().getId(),
+              pool_host_again.get_allocator().getId());
+
+    {
+      // more than the initial pool size, so the pools have to grow
+      device_view_type p1(view_ctor_prop_device("p1", pool_device), 2 * N);
+      host_view_type p2(view_ctor_prop_host("p2", pool_host), 2 * N);
+      host_view_type p3(view_ctor_prop_host("p3", pool_list_host), 2 * N);
+
+      auto h_p1 = Kokkos::create_mirror(Kokkos::HostSpace(), p1);
+      auto h_p2 = Kokkos::create_mirror(Kokkos::HostSpace(), p2);
+      auto h_p3 = Kokkos::create_mirror(Kokkos::HostSpace(), p3);
+
+      for (int i = 0; i < 2 * N; i++) {
+        h_p1(i) = i;
+        h_p2(i) = i * 2;
+        h_p3(i) = i * 3;
+      }
+      Kokkos::deep_copy(p1, h_p1);
+      Kokkos::deep_copy(p2, h_p2);
+      Kokkos::deep_copy(p3, h_p3);
+
+      Kokkos::parallel_for(
+          Kokkos::RangePolicy<Kokkos::DefaultExecutionSpace>(0, 2 * N),
+          KOKKOS_LAMBDA(const int i) { p1(i) *= 2; });
+      Kokkos::fence();
+      Kokkos::parallel_for(
+          Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, 2 * N),
+          KOKKOS_LAMBDA(const int i) {
+            p2(i) *= 2;
+            p3(i) *= 2;
+          });
+
+      Kokkos::deep_copy(h_p1, p1);
+      Kokkos::deep_copy(h_p2, p2);
+      Kokkos::deep_copy(h_p3, p3);
+
+      for (int i = 0; i < 2 * N; i++) {
+        ASSERT_EQ(h_p1(i), 2 * i);
+        ASSERT_EQ(h_p2(i), i * 4);
+        ASSERT_EQ(h_p3(i), i * 6);
+      }
+    }
 
     // typed allocator
     //
     printf("tests complete, let the descoping begin...\n");
   }
+
+  template <class ViewType>
+  static void check_alignment(const ViewType& v, const size_t alignment) {
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(v.data()) % alignment, 0u);
+  }
+
+  void run_alignment_tests() {
+    // default spaces and pools align to Kokkos' MEMORY_ALIGNMENT
+    {
+      host_view_type v1(view_ctor_prop_host("v1", mem_space_host()), N + 1);
+      device_view_type v2(view_ctor_prop_device("v2", mem_space_device()),
+                          N + 1);
+      host_view_type v3(
+          view_ctor_prop_host("v3", mem_space_host::make_pool(
+                                        "umpire_test_host_aligned_pool",
+                                        N * sizeof(T), N * sizeof(T))),
+          N + 1);
+      check_alignment(v1, Kokkos::Impl::MEMORY_ALIGNMENT);
+      check_alignment(v2, Kokkos::Impl::MEMORY_ALIGNMENT);
+      check_alignment(v3, Kokkos::Impl::MEMORY_ALIGNMENT);
+    }
+
+    // which the default host allocator guarantees by itself, so nothing is
+    // padded: a View only adds its header, a raw allocation nothing
+    {
+      mem_space_host host;
+      const size_t header = sizeof(Kokkos::Impl::SharedAllocationHeader);
+      const auto before   = host.statistics();
+      {
+        host_view_type v(view_ctor_prop_host("v", host), N);
+        ASSERT_EQ(host.statistics().overhead_bytes - before.overhead_bytes,
+                  header);
+      }
+      void* ptr = host.allocate(N * sizeof(T));
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % host.alignment(), 0u);
+      ASSERT_EQ(host.statistics().overhead_bytes, before.overhead_bytes);
+      host.deallocate(ptr, N * sizeof(T));
+    }
+
+    // make_pool on the name of an allocator that is not one of its pools
+    // returns that allocator, which only aligns like malloc, so the space
+    // pads
+    {
+      mem_space_host host = mem_space_host::make_pool("HOST", 1, 1);
+      for (int n : {1, N, 3 * N + 1}) {
+        host_view_type v(view_ctor_prop_host("v", host), n);
+        check_alignment(v, Kokkos::Impl::MEMORY_ALIGNMENT);
+        void* ptr = host.allocate(n * sizeof(T));
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % host.alignment(), 0u);
+        host.deallocate(ptr, n * sizeof(T));
+      }
+    }
+
+    // cache line, page and huge page
+    for (size_t alignment : {size_t(64), size_t(4096), size_t(2 << 20)}) {
+      mem_space_host host_space     = mem_space_host::make_aligned(alignment);
+      mem_space_device device_space = mem_space_device::make_aligned(alignment);
+      ASSERT_EQ(host_space.alignment(), alignment);
+
+      for (int n : {1, N, 1000 * N}) {
+        host_view_type v1(view_ctor_prop_host("v1", host_space), n);
+        device_view_type v2(view_ctor_prop_device("v2", device_space), n);
+        check_alignment(v1, alignment);
+        check_alignment(v2, alignment);
+
+        // the memory is usable end to end
+        Kokkos::deep_copy(v1, T(1));
+        Kokkos::deep_copy(v2, T(2));
+        auto h_v1 =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), v1);
+        auto h_v2 =
+            Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), v2);
+        ASSERT_EQ(h_v1(n - 1), T(1));
+        ASSERT_EQ(h_v2(n - 1), T(2));
+      }
+
+      // raw allocations from the space are aligned as well
+      void* ptr = host_space.allocate(3 * sizeof(T));
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, 0u);
+      host_space.deallocate(ptr, 3 * sizeof(T));
+    }
+  }
+
+#if defined(__linux__)
+  void run_huge_page_tests() {
+    Kokkos::UmpireHostSpace huge(Kokkos::Impl::umpire_huge_page_name);
+    using view_type = Kokkos::View<T*, Kokkos::UmpireHostSpace>;
+
+    // below and above the huge page threshold
+    for (size_t n : {size_t(N), 3 * Kokkos::Impl::umpire_huge_page_bytes}) {
+      view_type v(view_ctor_prop_host("v", huge), n);
+      auto h_v = Kokkos::create_mirror(Kokkos::HostSpace(), v);
+      for (size_t i = 0; i < n; i++) h_v(i) = i;
+      Kokkos::deep_copy(v, h_v);
+      Kokkos::parallel_for(
+          Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, n),
+          KOKKOS_LAMBDA(const int i) { v(i) *= 2; });
+      Kokkos::fence();
+      Kokkos::deep_copy(h_v, v);
+      for (size_t i = 0; i < n; i++) ASSERT_EQ(h_v(i), 2 * i);
+    }
+
+    // mappings are huge page aligned, so a View that fits one huge page
+    // with its header is not padded into a second one
+    const size_t header = sizeof(Kokkos::Impl::SharedAllocationHeader);
+    const size_t bytes  = Kokkos::Impl::umpire_huge_page_bytes - header;
+    const auto before   = huge.statistics();
+    {
+      view_type v(view_ctor_prop_host("v", huge), bytes / sizeof(T));
+      check_alignment(v, Kokkos::Impl::MEMORY_ALIGNMENT);
+      const auto stats = huge.statistics();
+      ASSERT_EQ(stats.overhead_bytes - before.overhead_bytes, header);
+      ASSERT_LE(stats.current_bytes - before.current_bytes,
+                Kokkos::Impl::umpire_huge_page_bytes);
+    }
+  }
+
+  void run_file_tests() {
+    using view_type = Kokkos::View<T*, Kokkos::UmpireHostSpace>;
+    const size_t n  = 4 * Kokkos::Impl::umpire_file_threshold / sizeof(T);
+
+    Kokkos::UmpireFileOptions full;
+    full.sparse = false;
+    full.access = Kokkos::UmpireFileAccess::Sequential;
+    ASSERT_EQ(Kokkos::Impl::umpire_file_allocator_name(full),
+              "HOST_FILE_FULL_SEQUENTIAL");
+
+    for (const auto& space :
+         {Kokkos::UmpireHostSpace::make_file(),
+          Kokkos::UmpireHostSpace::make_file(full),
+          Kokkos::UmpireHostSpace(Kokkos::Impl::umpire_file_prefix)}) {
+      view_type v(view_ctor_prop_host("v", space), n);
+      auto h_v = Kokkos::create_mirror(Kokkos::HostSpace(), v);
+      for (size_t i = 0; i < n; i++) h_v(i) = i;
+      Kokkos::deep_copy(v, h_v);
+      Kokkos::parallel_for(
+          Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, n),
+          KOKKOS_LAMBDA(const int i) { v(i) *= 2; });
+      Kokkos::fence();
+
+      // between two file backed Views as well
+      view_type w(view_ctor_prop_host("w", space), n);
+      Kokkos::deep_copy(w, v);
+      Kokkos::deep_copy(h_v, w);
+      for (size_t i = 0; i < n; i++) ASSERT_EQ(h_v(i), 2 * i);
+    }
+
+    Kokkos::UmpireFileOptions missing;
+    missing.directory = "/nonexistent/kokkos_umpire_test";
+    auto nowhere      = Kokkos::UmpireHostSpace::make_file(missing);
+    ASSERT_THROW(view_type(view_ctor_prop_host("v", nowhere), n),
+                 std::runtime_error);
+  }
+
+  void run_shared_tests() {
+    using table_type =
+        Kokkos::View<const T*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>;
+    using Kokkos::Experimental::umpire_attach_shared;
+    using Kokkos::Experimental::umpire_detach_shared;
+
+    // a prefix of our own, so that test binaries running at once do not
+    // see each other's segments
+    const std::string prefix =
+        "kokkos_umpire_test_" + std::to_string(getpid());
+    mem_space_host shared = mem_space_host::make_node_shared(prefix.c_str());
+    table_type attached;
+    {
+      host_view_type table(view_ctor_prop_host("table", shared), N);
+      for (int i = 0; i < N; i++) table(i) = i;
+
+      // another process on the node sees the same memory
+      const pid_t pid = fork();
+      if (pid == 0) {
+        int status = 0;
+        try {
+          table_type t = umpire_attach_shared<table_type>(shared, "table", N);
+          for (int i = 0; i < N; i++) {
+            if (t(i) != T(i)) status = 1;
+          }
+          umpire_detach_shared(t);
+        } catch (...) {
+          status = 2;
+        }
+        _exit(status);
+      }
+      int status = -1;
+      ASSERT_EQ(waitpid(pid, &status, 0), pid);
+      ASSERT_TRUE(WIFEXITED(status));
+      ASSERT_EQ(WEXITSTATUS(status), 0);
+
+      attached = umpire_attach_shared<table_type>(shared, "table", N);
+      ASSERT_NE(attached.data(), table.data());
+      table(N - 1) = 2 * N;
+      ASSERT_EQ(attached(N - 1), T(2 * N));
+
+      // more than there is
+      ASSERT_THROW(umpire_attach_shared<table_type>(shared, "table", 2 * N),
+                   std::runtime_error);
+
+      // Views with the same label can be alive at once, the newest one is
+      // attached to
+      {
+        host_view_type newer(view_ctor_prop_host("table", shared), N);
+        newer(0)     = T(N);
+        table_type t = umpire_attach_shared<table_type>(shared, "table", N);
+        ASSERT_EQ(t(0), T(N));
+        umpire_detach_shared(t);
+      }
+
+      // as when an allocation grows by copying it to a new one
+      using record_type =
+          Kokkos::Impl::SharedAllocationRecord<mem_space_host, void>;
+      T* grown = static_cast<T*>(
+          record_type::allocate_tracked(shared, "grown", N * sizeof(T)));
+      grown[N - 1] = T(N);
+      grown        = static_cast<T*>(
+          record_type::reallocate_tracked(grown, 2 * N * sizeof(T)));
+      table_type t = umpire_attach_shared<table_type>(shared, "grown", 2 * N);
+      ASSERT_EQ(t(N - 1), T(N));
+      umpire_detach_shared(t);
+      record_type::deallocate_tracked(grown);
+    }
+
+    // the segment is gone with the View, attached mappings stay valid
+    ASSERT_EQ(attached(0), T(0));
+    umpire_detach_shared(attached);
+    ASSERT_THROW(umpire_attach_shared<table_type>(shared, "table", N),
+                 std::runtime_error);
+  }
+
+  void run_numa_tests() {
+    using view_type = Kokkos::View<T*, Kokkos::UmpireHostSpace>;
+    // node ids need not be contiguous, e.g. "0-3,5"
+    const int last  = Kokkos::Impl::umpire_numa_nodes().back();
+
+    for (auto space : {Kokkos::UmpireHostSpace::make_numa(
+                           Kokkos::UmpireNumaPolicy::Interleave),
+                       Kokkos::UmpireHostSpace::make_numa(
+                           Kokkos::UmpireNumaPolicy::Bind, last),
+                       Kokkos::UmpireHostSpace::make_numa(
+                           Kokkos::UmpireNumaPolicy::FirstTouch)}) {
+      // below and above the placement thresholds
+      for (size_t n : {size_t(N), Kokkos::Impl::umpire_first_touch_min_bytes}) {
+        view_type v(view_ctor_prop_host("v", space), n);
+        ASSERT_EQ(v.label(), "v");
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, n),
+            KOKKOS_LAMBDA(const int i) { v(i) = 3 * i; });
+        Kokkos::fence();
+        for (size_t i = 0; i < n; i++) ASSERT_EQ(v(i), 3 * i);
+      }
+    }
+
+    ASSERT_THROW(
+        Kokkos::UmpireHostSpace::make_numa(Kokkos::UmpireNumaPolicy::Bind, -1),
+        std::runtime_error);
+  }
+#endif
+
+  void run_exec_deep_copy_tests() {
+    exec_host exec;
+    mem_space_host host_space;
+    host_view_type a(view_ctor_prop_host("a", host_space), N);
+    host_view_type b(view_ctor_prop_host("b", host_space), N);
+    Kokkos::View<T*, Kokkos::HostSpace> h("h", N);
+
+    // the copies are ordered after the kernel on the same instance, without
+    // fencing in between
+    Kokkos::parallel_for(
+        Kokkos::RangePolicy<exec_host>(exec, 0, N),
+        KOKKOS_LAMBDA(const int i) { a(i) = 5 * i; });
+    Kokkos::deep_copy(exec, b, a);
+    Kokkos::deep_copy(exec, h, b);
+    exec.fence();
+    for (int i = 0; i < N; i++) ASSERT_EQ(h(i), 5 * i);
+
+    Kokkos::parallel_for(
+        Kokkos::RangePolicy<exec_host>(exec, 0, N),
+        KOKKOS_LAMBDA(const int i) { h(i) = 7 * i; });
+    Kokkos::deep_copy(exec, a, h);
+    exec.fence();
+    for (int i = 0; i < N; i++) ASSERT_EQ(a(i), 7 * i);
+
+    // copies above the threshold are chunked over the host threads, check
+    // chunk boundaries with a size and an offset that are not page multiples
+    const size_t threshold = Kokkos::Impl::umpire_parallel_copy_threshold();
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(1024);
+    const int M = 100003;
+    host_view_type c(view_ctor_prop_host("c", host_space), M);
+    Kokkos::View<T*, Kokkos::HostSpace> g("g", M);
+    for (int i = 0; i < M; i++) g(i) = i;
+    auto range = std::make_pair(3, M);
+    Kokkos::deep_copy(Kokkos::subview(c, range), Kokkos::subview(g, range));
+    Kokkos::deep_copy(g, T(0));
+    Kokkos::deep_copy(exec, Kokkos::subview(g, range),
+                      Kokkos::subview(c, range));
+    exec.fence();
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(threshold);
+    for (int i = 3; i < M; i++) ASSERT_EQ(g(i), i);
+  }
+
+  void run_deep_copy_batch_tests() {
+    exec_host exec;
+    mem_space_host host_space;
+    const int M = 2 * N;
+
+    std::vector<host_view_type> u;
+    std::vector<Kokkos::View<T*, Kokkos::HostSpace>> h;
+    for (int k = 0; k < 8; k++) {
+      u.emplace_back(view_ctor_prop_host("u", host_space), N + k);
+      h.emplace_back("h", N + k);
+      for (int i = 0; i < N + k; i++) h[k](i) = k * N + i;
+    }
+    Kokkos::View<T**, Kokkos::LayoutRight, mem_space_host> u2(
+        view_ctor_prop_host("u2", host_space), N, 3);
+    Kokkos::View<T**, Kokkos::LayoutLeft, Kokkos::HostSpace> h2("h2", N, 3);
+    Kokkos::View<T**, Kokkos::LayoutRight, Kokkos::HostSpace> g2("g2", N, 3);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < 3; j++) h2(i, j) = 3 * i + j;
+    }
+    device_view_type d(view_ctor_prop_device("d", mem_space_device()), M);
+    Kokkos::View<T*, Kokkos::HostSpace> e("e", M);
+    Kokkos::deep_copy(e, T(1));
+
+    // host -> umpire, different layouts (done by deep_copy) and a copy to
+    // the default device in one batch
+    std::vector<Kokkos::Experimental::DeepCopyBatchEntry<exec_host>> copies;
+    for (int k = 0; k < 8; k++) copies.emplace_back(u[k], h[k]);
+    copies.emplace_back(u2, h2);
+    copies.emplace_back(d, e);
+    Kokkos::Experimental::deep_copy_batch(exec, copies);
+    exec.fence();
+
+    for (int k = 0; k < 8; k++) Kokkos::deep_copy(h[k], T(0));
+    Kokkos::deep_copy(e, T(0));
+
+    // and back, synchronously
+    Kokkos::Experimental::deep_copy_batch(
+        {{h[0], u[0]}, {h[3], u[3]}, {h[7], u[7]}, {g2, u2}, {e, d}});
+
+    for (int k : {0, 3, 7}) {
+      for (int i = 0; i < N + k; i++) ASSERT_EQ(h[k](i), k * N + i);
+    }
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < 3; j++) ASSERT_EQ(g2(i, j), 3 * i + j);
+    }
+    for (int i = 0; i < M; i++) ASSERT_EQ(e(i), 1);
+  }
+
+  void run_statistics_tests() {
+    const char* name     = "umpire_test_statistics_pool";
+    mem_space_host space = mem_space_host::make_pool(name, N, N);
+    const size_t header  = sizeof(Kokkos::Impl::SharedAllocationHeader);
+    const size_t bytes   = 3 * N * sizeof(T) + 2 * header;
+
+    // counts relative to what earlier tests left behind in the pool
+    const auto before = space.statistics();
+    ASSERT_EQ(before.allocator_name, name);
+    {
+      host_view_type a(view_ctor_prop_host("a", space), N);
+      host_view_type b(view_ctor_prop_host("b", space), 2 * N);
+
+      auto stats = space.statistics();
+      ASSERT_EQ(stats.allocations - before.allocations, 2u);
+      ASSERT_EQ(stats.deallocations, before.deallocations);
+      ASSERT_EQ(stats.overhead_bytes - before.overhead_bytes, 2 * header);
+      ASSERT_EQ(stats.current_bytes - before.current_bytes, bytes);
+      ASSERT_GE(stats.peak_bytes, stats.current_bytes);
+    }
+
+    auto stats = space.statistics();
+    ASSERT_EQ(stats.allocations - before.allocations, 2u);
+    ASSERT_EQ(stats.deallocations - before.deallocations, 2u);
+    ASSERT_EQ(stats.current_bytes, before.current_bytes);
+    ASSERT_EQ(stats.overhead_bytes, before.overhead_bytes);
+    ASSERT_GE(stats.peak_bytes, before.current_bytes + bytes);
+
+    // alignment padding counts as overhead, and spaces sharing the
+    // allocator share the statistics
+    mem_space_host aligned = mem_space_host::make_aligned(4096, space);
+    {
+      host_view_type c(view_ctor_prop_host("c", aligned), N);
+      ASSERT_GE(space.statistics().overhead_bytes - before.overhead_bytes,
+                4096 + header);
+      ASSERT_EQ(space.statistics().allocations - before.allocations, 3u);
+    }
+    ASSERT_EQ(space.statistics().overhead_bytes, before.overhead_bytes);
+
+    bool found = false;
+    for (const auto& s : Kokkos::umpire_space_statistics()) {
+      if (s.allocator_name == name) found = true;
+    }
+    ASSERT_TRUE(found);
+
+    std::ostringstream out;
+    Kokkos::print_umpire_space_statistics(out);
+    ASSERT_NE(out.str().find(name), std::string::npos);
+  }
+
+  void run_pool_event_tests() {
+    std::vector<Kokkos::UmpirePoolEvent> events;
+    Kokkos::set_umpire_pool_event_callback(
+        [&](const Kokkos::UmpirePoolEvent& event) { events.push_back(event); });
+
+    const char* name     = "umpire_test_pool_events";
+    mem_space_host space = mem_space_host::make_pool(name, N, N);
+    {
+      // more than the initial block, so the pool has to grow
+      host_view_type a(view_ctor_prop_host("a", space), N);
+      host_view_type b(view_ctor_prop_host("b", space), N);
+    }
+    ASSERT_GE(events.size(), 2u);
+    for (const auto& event : events) {
+      ASSERT_EQ(std::string(event.pool_name), name);
+      ASSERT_EQ(event.kind, Kokkos::UmpirePoolEventKind::Grow);
+      ASSERT_GT(event.bytes, 0u);
+    }
+
+    // free blocks go back upstream on release
+    const size_t grown = events.size();
+    space.get_allocator().release();
+    ASSERT_GT(events.size(), grown);
+    ASSERT_EQ(events.back().kind, Kokkos::UmpirePoolEventKind::Release);
+
+    Kokkos::set_umpire_pool_event_callback(nullptr);
+  }
+
+  void run_reallocate_tests() {
+    using record_base = Kokkos::Impl::SharedAllocationRecord<void, void>;
+    using record_type =
+        Kokkos::Impl::SharedAllocationRecord<mem_space_host, void>;
+    const size_t bytes = N * sizeof(T);
+    const int half     = N / 2 + 1;
+
+    // within its capacity an allocation is resized where it is
+    mem_space_host pool = mem_space_host::make_pool(
+        "umpire_test_reallocate_pool", 8 * bytes, 8 * bytes);
+    T* a = static_cast<T*>(record_type::allocate_tracked(pool, "a", bytes));
+    for (int i = 0; i < N; i++) a[i] = i;
+
+    T* b = static_cast<T*>(
+        record_type::reallocate_tracked(a, half * sizeof(T)));
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(record_type::get_record(b)->size(), half * sizeof(T));
+    b = static_cast<T*>(record_type::reallocate_tracked(b, bytes));
+    ASSERT_EQ(b, a);
+    ASSERT_EQ(record_type::get_record(b)->get_label(), "a");
+    for (int i = 0; i < half; i++) ASSERT_EQ(b[i], i);
+
+    // beyond it a pool allocation is copied
+    T* c = static_cast<T*>(record_type::reallocate_tracked(b, 4 * bytes));
+    ASSERT_EQ(record_type::get_record(c)->size(), 4 * bytes);
+    for (int i = 0; i < half; i++) ASSERT_EQ(c[i], i);
+
+    // and so is one somebody else still refers to
+    record_base::increment(record_type::get_record(c));
+    T* d = static_cast<T*>(record_type::reallocate_tracked(c, 3 * bytes));
+    ASSERT_NE(d, c);
+    for (int i = 0; i < half; i++) ASSERT_EQ(d[i], i);
+    record_base::decrement(record_type::get_record(c));
+    record_type::deallocate_tracked(d);
+
+    // the most recent allocation of an arena grows in place
+    mem_space_host arena = mem_space_host::make_arena(8 * bytes);
+    T* e = static_cast<T*>(record_type::allocate_tracked(arena, "e", bytes));
+    T* f = static_cast<T*>(record_type::reallocate_tracked(e, 4 * bytes));
+    ASSERT_EQ(f, e);
+    record_type::deallocate_tracked(f);
+    arena.reset();
+
+    // large host allocations are reallocated (remapped) by Umpire
+    mem_space_host host;
+    const size_t n = 1 << 20;
+    T* g = static_cast<T*>(
+        record_type::allocate_tracked(host, "g", n * sizeof(T)));
+    for (size_t i = 0; i < n; i++) g[i] = i;
+    T* h = static_cast<T*>(
+        record_type::reallocate_tracked(g, 2 * n * sizeof(T)));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(h) % host.alignment(), 0u);
+    for (size_t i = 0; i < n; i++) ASSERT_EQ(h[i], T(i));
+    ASSERT_EQ(record_type::get_record(h)->get_label(), "g");
+    record_type::deallocate_tracked(h);
+  }
+
+  void run_fill_tests() {
+    using Kokkos::Experimental::umpire_fill;
+    using Kokkos::Experimental::umpire_zero;
+    mem_space_host host;
+
+    // uniform bytes are set with a memset, anything else by deep_copy
+    host_view_type a(view_ctor_prop_host("a", host), N);
+    umpire_fill(a, T(1.5));
+    for (int i = 0; i < N; i++) ASSERT_EQ(a(i), T(1.5));
+    umpire_zero(a);
+    for (int i = 0; i < N; i++) ASSERT_EQ(a(i), T(0));
+
+    // large fills are chunked over the host threads
+    const size_t threshold = Kokkos::Impl::umpire_parallel_copy_threshold();
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(1024);
+    host_view_type b(view_ctor_prop_host("b", host), 64 * N);
+    Kokkos::deep_copy(b, T(1));
+    umpire_zero(b);
+    for (int i = 0; i < 64 * N; i++) ASSERT_EQ(b(i), T(0));
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(threshold);
+
+    device_view_type d(view_ctor_prop_device("d", mem_space_device()), N);
+    umpire_fill(d, T(0));
+    Kokkos::deep_copy(a, T(1));
+    Kokkos::deep_copy(a, d);
+    for (int i = 0; i < N; i++) ASSERT_EQ(a(i), T(0));
+
+    // reused pool memory is zeroed for a zeroed space
+    mem_space_host pool = mem_space_host::make_pool(
+        "umpire_test_zeroed_pool", 4 * N * sizeof(T), 4 * N * sizeof(T));
+    {
+      host_view_type c(view_ctor_prop_host("c", pool), N);
+      Kokkos::deep_copy(c, T(1));
+    }
+    mem_space_host zeroed = mem_space_host::make_zeroed(pool);
+    host_view_type c(
+        Kokkos::view_alloc("c", zeroed, Kokkos::WithoutInitializing), N);
+    for (int i = 0; i < N; i++) ASSERT_EQ(c(i), T(0));
+
+    // and so is what a zeroed allocation grows by, within its capacity
+    // (over what a shrink left behind) and beyond it
+    {
+      using record_type =
+          Kokkos::Impl::SharedAllocationRecord<mem_space_host, void>;
+      const size_t bytes = N * sizeof(T);
+      T* z = static_cast<T*>(record_type::allocate_tracked(zeroed, "z", bytes));
+      for (int i = 0; i < N; i++) z[i] = T(1);
+      z = static_cast<T*>(record_type::reallocate_tracked(z, bytes - 8));
+      z = static_cast<T*>(record_type::reallocate_tracked(z, bytes));
+      for (int i = 0; i < N - 1; i++) ASSERT_EQ(z[i], T(1));
+      ASSERT_EQ(z[N - 1], T(0));
+      z = static_cast<T*>(record_type::reallocate_tracked(z, 3 * bytes));
+      for (int i = 0; i < N - 1; i++) ASSERT_EQ(z[i], T(1));
+      for (int i = N - 1; i < 3 * N; i++) ASSERT_EQ(z[i], T(0));
+      record_type::deallocate_tracked(z);
+
+      // the same through realloc on the default host allocator
+      mem_space_host zeroed_host = mem_space_host::make_zeroed();
+      T* h = static_cast<T*>(
+          record_type::allocate_tracked(zeroed_host, "h", bytes));
+      for (int i = 0; i < N; i++) h[i] = T(1);
+      h = static_cast<T*>(record_type::reallocate_tracked(h, 16 * bytes));
+      for (int i = 0; i < N; i++) ASSERT_EQ(h[i], T(1));
+      for (int i = N; i < 16 * N; i++) ASSERT_EQ(h[i], T(0));
+      record_type::deallocate_tracked(h);
+    }
+
+#if defined(__linux__)
+    // fresh huge pages are zero already
+    mem_space_host huge =
+        mem_space_host::make_zeroed(mem_space_host("HOST_HUGEPAGE"));
+    const int n = Kokkos::Impl::umpire_huge_page_bytes / sizeof(T);
+    host_view_type e(
+        Kokkos::view_alloc("e", huge, Kokkos::WithoutInitializing), n);
+    for (int i = 0; i < n; i++) ASSERT_EQ(e(i), T(0));
+#endif
+  }
+
+  void run_prewarm_tests() {
+    auto& rm = umpire::ResourceManager::getInstance();
+
+    const std::string config = "umpire_test_prewarm.json";
+    std::ofstream(config) << R"({
+      "allocators": ["HOST_HUGEPAGE"],
+      "pools": [{"name": "umpire_test_prewarm_pool", "initial_bytes": "1M",
+                 "grow_bytes": 65536, "strategy": "DynamicPoolList"}]
+    })";
+    Kokkos::umpire_prewarm(config);
+    std::remove(config.c_str());
+
+    ASSERT_TRUE(rm.isAllocator("HOST_HUGEPAGE"));
+    ASSERT_TRUE(rm.isAllocator("umpire_test_prewarm_pool"));
+    // the initial block is held by the pool already
+    auto pool = rm.getAllocator("umpire_test_prewarm_pool");
+    ASSERT_GE(pool.getActualSize(), size_t(1) << 20);
+    ASSERT_EQ(pool.getCurrentSize(), 0u);
+
+    // make_pool hands out the prewarmed pool
+    mem_space_host space =
+        mem_space_host::make_pool("umpire_test_prewarm_pool", 1, 1);
+    ASSERT_EQ(space.get_allocator().getId(), pool.getId());
+
+    setenv("KOKKOS_UMPIRE_POOLS", "umpire_test_prewarm_env:64K:4K", 1);
+    Kokkos::umpire_prewarm();
+    unsetenv("KOKKOS_UMPIRE_POOLS");
+    ASSERT_GE(rm.getAllocator("umpire_test_prewarm_env").getActualSize(),
+              size_t(64) << 10);
+
+    // escapes in strings
+    std::ofstream(config) << R"({"pools": [
+      {"name": "umpire_test_prewarm_\u0065sc\u00e9", "initial_bytes": 4096,
+       "upstream": "HO\u0053T", "touch": false}]})";
+    Kokkos::umpire_prewarm(config);
+    ASSERT_TRUE(rm.isAllocator("umpire_test_prewarm_esc\xc3\xa9"));
+
+    for (const char* invalid :
+         {R"({"pools": [{"name": "x"}]})",
+          R"({"allocators": "HOST"})",
+          R"({"pools": {"name": "x", "initial_bytes": 1}})",
+          R"({"pools": ["x"]})",
+          R"({"pools": [{"name": "x", "initial_bytes": 1, "upstream": 1}]})",
+          R"({"pools": [{"name": "x", "initial_bytes": 1, "strategy": 1}]})",
+          R"({"pools": [{"name": "x", "initial_bytes": 1, "touch": "no"}]})",
+          R"({"allocators": ["HO\qST"]})",
+          R"({"allocators": ["HO\u00ST"]})",
+          R"({"allocators": ["HO\ud800ST"]})",
+          R"({"pools": [{"name": "x", "initial_bytes": 1e30}]})",
+          R"({"pools": [{"name": "x", "initial_bytes": "1e30"}]})"}) {
+      std::ofstream(config) << invalid;
+      ASSERT_THROW(Kokkos::umpire_prewarm(config), std::runtime_error)
+          << invalid;
+    }
+    std::remove(config.c_str());
+
+    ASSERT_EQ(Kokkos::Impl::umpire_parse_bytes("3K", "test"), size_t(3072));
+    ASSERT_EQ(Kokkos::Impl::umpire_parse_bytes("1.5M", "test"),
+              size_t(3 << 19));
+    for (const char* invalid : {"3X", "", ".", "K", " 1", "1 ", "-1", "+1",
+                                "1e3", "0x10", "inf", "nan", "1.2.3",
+                                "99999999999999999999G"}) {
+      ASSERT_THROW(Kokkos::Impl::umpire_parse_bytes(invalid, "test"),
+                   std::runtime_error)
+          << invalid;
+    }
+  }
+
+  void run_size_class_tests() {
+    mem_space_device classes = mem_space_device::make_size_classes();
+    auto& rm                 = umpire::ResourceManager::getInstance();
+    // N values and the View header round up to the 1 KiB class
+    auto pool = rm.getAllocator(classes.get_allocator().getName() +
+                                "::size_class_1024");
+
+    const size_t pool_bytes = pool.getCurrentSize();
+    T* small_ptr            = nullptr;
+    {
+      device_view_type small(view_ctor_prop_device("small", classes), N);
+      device_view_type large(view_ctor_prop_device("large", classes), 16 * N);
+
+      // the small View takes a whole object of its class, the large one
+      // goes to the upstream allocator
+      ASSERT_EQ(pool.getCurrentSize(), pool_bytes + 1024);
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(small.data()) %
+                    Kokkos::Impl::MEMORY_ALIGNMENT,
+                0u);
+      small_ptr = small.data();
+
+      Kokkos::parallel_for(
+          Kokkos::RangePolicy<Kokkos::DefaultExecutionSpace>(0, N),
+          KOKKOS_LAMBDA(const int i) {
+            small(i)      = i;
+            large(16 * i) = small(i) + 1;
+          });
+
+      auto h_large = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(),
+                                                         large);
+      for (int i = 0; i < N; i++) {
+        ASSERT_EQ(h_large(16 * i), i + 1);
+      }
+    }
+    ASSERT_EQ(pool.getCurrentSize(), pool_bytes);
+
+    // a freed object is handed out again
+    device_view_type again(view_ctor_prop_device("again", classes), N);
+    ASSERT_EQ(again.data(), small_ptr);
+
+    ASSERT_THROW(mem_space_device::make_size_classes(1000), std::runtime_error);
+  }
+
+  void run_thread_cache_tests() {
+    mem_space_host cached = mem_space_host::make_thread_cache();
+
+    // a freed object goes back to the list of its thread and is handed out
+    // again by the next request of its size class
+    void* first = cached.allocate(100);
+    cached.deallocate(first, 100);
+    void* again = cached.allocate(128);
+    ASSERT_EQ(again, first);
+    cached.deallocate(again, 128);
+
+    // requests of every size class from all threads at once, each filled
+    // with a pattern of its own and checked before free, so that objects
+    // handed to two threads at a time show up as errors
+    const int iterations = 256 * exec_host().concurrency();
+    const size_t sizes[] = {size_t(8), size_t(64), size_t(100), size_t(1000),
+                            size_t(4096)};
+
+    int errors = 0;
+    Kokkos::parallel_reduce(
+        Kokkos::RangePolicy<exec_host>(0, iterations),
+        [=](const int i, int& lerrors) {
+          void* ptrs[5];
+          for (int r = 0; r < 5; r++) {
+            ptrs[r] = cached.allocate(sizes[r]);
+            if (reinterpret_cast<uintptr_t>(ptrs[r]) %
+                    Kokkos::Impl::umpire_thread_cache_min_bytes !=
+                0) {
+              ++lerrors;
+            }
+            std::memset(ptrs[r], (i + r) & 0xff, sizes[r]);
+          }
+          for (int r = 0; r < 5; r++) {
+            const unsigned char* bytes =
+                static_cast<const unsigned char*>(ptrs[r]);
+            for (size_t b = 0; b < sizes[r]; b++) {
+              if (bytes[b] != ((i + r) & 0xff)) {
+                ++lerrors;
+                break;
+              }
+            }
+            cached.deallocate(ptrs[r], sizes[r]);
+          }
+        },
+        errors);
+    ASSERT_EQ(errors, 0);
+  }
+
+  void run_thread_safe_tests() {
+    // a pool, which Umpire does not make thread safe by itself, with size
+    // classes in front
+    mem_space_host safe =
+        mem_space_host::make_thread_safe(mem_space_host::make_size_classes(
+            16 * 1024, mem_space_host::make_pool("umpire_test_thread_safe_pool",
+                                                 1 << 20, 1 << 20)));
+    ASSERT_TRUE(safe.is_thread_safe());
+    ASSERT_FALSE(mem_space_host().is_thread_safe());
+    ASSERT_EQ(safe.get_allocator().getName(),
+              "umpire_test_thread_safe_pool::thread_safe");
+
+    // thread cached, size classed and pooled requests from all threads at
+    // once, each filled with a pattern of its own and checked before free
+    const int iterations = 256 * exec_host().concurrency();
+    const size_t sizes[] = {size_t(64), size_t(1000), size_t(12000),
+                            size_t(100000)};
+    const auto before    = safe.statistics();
+
+    int errors = 0;
+    Kokkos::parallel_reduce(
+        Kokkos::RangePolicy<exec_host>(0, iterations),
+        [=](const int i, int& lerrors) {
+          void* ptrs[4];
+          for (int r = 0; r < 4; r++) {
+            ptrs[r] = safe.allocate(sizes[r]);
+            std::memset(ptrs[r], (i + r) & 0xff, sizes[r]);
+          }
+          for (int r = 0; r < 4; r++) {
+            const unsigned char* bytes =
+                static_cast<const unsigned char*>(ptrs[r]);
+            if (bytes[0] != ((i + r) & 0xff) ||
+                bytes[sizes[r] - 1] != ((i + r) & 0xff)) {
+              ++lerrors;
+            }
+            safe.deallocate(ptrs[r], sizes[r]);
+          }
+        },
+        errors);
+    ASSERT_EQ(errors, 0);
+
+    const auto stats = safe.statistics();
+    ASSERT_EQ(stats.allocations - before.allocations, 4u * iterations);
+    ASSERT_EQ(stats.deallocations - before.deallocations, 4u * iterations);
+    ASSERT_EQ(stats.current_bytes, before.current_bytes);
+
+    // zeroed and first touch spaces fill (touch) large allocations with a
+    // kernel, which cannot be dispatched from a parallel region
+    const size_t threshold = Kokkos::Impl::umpire_parallel_copy_threshold();
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(1024);
+    const size_t bytes = Kokkos::Impl::umpire_first_touch_min_bytes;
+    for (const bool zeroed : {true, false}) {
+      using space_type   = Kokkos::UmpireHostSpace;
+      const auto touched = space_type::make_thread_safe(
+          zeroed ? space_type::make_zeroed()
+                 : space_type::make_numa(Kokkos::UmpireNumaPolicy::FirstTouch));
+      errors = 0;
+      Kokkos::parallel_reduce(
+          Kokkos::RangePolicy<exec_host>(0, 4 * exec_host().concurrency()),
+          [=](const int i, int& lerrors) {
+            unsigned char* ptr =
+                static_cast<unsigned char*>(touched.allocate(bytes));
+            if (zeroed && (ptr[0] != 0 || ptr[bytes - 1] != 0)) ++lerrors;
+            std::memset(ptr, i & 0xff, bytes);
+            touched.deallocate(ptr, bytes);
+          },
+          errors);
+      ASSERT_EQ(errors, 0);
+    }
+    Kokkos::Impl::umpire_set_parallel_copy_threshold(threshold);
+
+    // arenas lock by themselves, on top of a thread safe space
+    ASSERT_THROW(
+        mem_space_host::make_thread_safe(mem_space_host::make_arena(1024)),
+        std::runtime_error);
+    ASSERT_TRUE(mem_space_host::make_arena(1024, safe).is_thread_safe());
+  }
+
+  void run_release_tests() {
+    mem_space_host pool = mem_space_host::make_pool("umpire_test_release_pool",
+                                                    1 << 20, 1 << 20);
+    auto allocator      = pool.get_allocator();
+    const int n         = (4 << 20) / sizeof(T);
+
+    // pools keep their peak until released
+    { host_view_type peak(view_ctor_prop_host("peak", pool), n); }
+    ASSERT_GE(allocator.getActualSize(), size_t(4) << 20);
+    ASSERT_GE(pool.release(), size_t(4) << 20);
+    ASSERT_LT(allocator.getActualSize(), size_t(4) << 20);
+
+    // released by the deallocation leaving more than free_bytes free
+    Kokkos::UmpireReleasePolicy policy;
+    policy.free_bytes = 1 << 20;
+    pool.set_release_policy(policy);
+    { host_view_type peak(view_ctor_prop_host("peak", pool), n); }
+    ASSERT_LT(allocator.getActualSize(), size_t(4) << 20);
+
+    // released at release points only
+    policy                   = Kokkos::UmpireReleasePolicy();
+    policy.at_release_points = true;
+    pool.set_release_policy(policy);
+    { host_view_type peak(view_ctor_prop_host("peak", pool), n); }
+    ASSERT_GE(allocator.getActualSize(), size_t(4) << 20);
+    Kokkos::umpire_release_point();
+    ASSERT_LT(allocator.getActualSize(), size_t(4) << 20);
+
+    pool.set_release_policy(Kokkos::UmpireReleasePolicy());
+
+    policy            = Kokkos::UmpireReleasePolicy();
+    policy.free_bytes = 1 << 20;
+    mem_space_host safe = mem_space_host::make_thread_safe(pool);
+    ASSERT_THROW(safe.set_release_policy(policy), std::runtime_error);
+  }
+
+  void run_trace_tests() {
+    using Kokkos::Experimental::UmpireTraceKind;
+    const std::string file = "umpire_test.trace";
+
+    Kokkos::Experimental::umpire_trace_start(file);
+    uintptr_t data         = 0;
+    uintptr_t batched_data = 0;
+    {
+      host_view_type traced(view_ctor_prop_host("traced", mem_space_host()),
+                            N);
+      auto h_traced = Kokkos::create_mirror(Kokkos::HostSpace(), traced);
+      Kokkos::deep_copy(traced, h_traced);
+      data = reinterpret_cast<uintptr_t>(traced.data());
+
+      host_view_type batched(view_ctor_prop_host("batched", mem_space_host()),
+                             N);
+      Kokkos::Experimental::deep_copy_batch({{batched, h_traced}});
+      batched_data = reinterpret_cast<uintptr_t>(batched.data());
+    }
+    Kokkos::Experimental::umpire_trace_stop();
+
+    Kokkos::Experimental::UmpireTrace trace;
+    ASSERT_TRUE(Kokkos::Experimental::umpire_read_trace(file, trace));
+    std::remove(file.c_str());
+
+    // the allocation of the View, the copies into the Views (batched ones
+    // included) and the deallocation
+    uint64_t ptr = 0;
+    bool copied  = false;
+    bool batched = false;
+    bool freed   = false;
+    for (const auto& record : trace.records) {
+      if (record.kind == UmpireTraceKind::Allocate &&
+          trace.names[record.label] == "traced") {
+        ASSERT_EQ(trace.names[record.allocator],
+                  mem_space_host().get_allocator().getName());
+        ASSERT_GE(record.bytes, N * sizeof(T));
+        ptr = record.ptr;
+      }
+      if (record.kind == UmpireTraceKind::Copy && record.ptr == data &&
+          record.bytes == N * sizeof(T)) {
+        copied = true;
+      }
+      if (record.kind == UmpireTraceKind::Copy && record.ptr == batched_data &&
+          record.bytes == N * sizeof(T)) {
+        batched = true;
+      }
+      if (record.kind == UmpireTraceKind::Deallocate && ptr &&
+          record.ptr == ptr) {
+        freed = true;
+      }
+    }
+    ASSERT_NE(ptr, 0u);
+    ASSERT_TRUE(copied);
+    ASSERT_TRUE(batched);
+    ASSERT_TRUE(freed);
+
+    ASSERT_FALSE(Kokkos::Experimental::umpire_read_trace(file, trace));
+
+    // corrupted traces: a single record after a valid header
+    using Kokkos::Experimental::UmpireTraceRecord;
+    auto read_corrupted = [&](const UmpireTraceRecord& corrupted) {
+      {
+        std::ofstream out(file, std::ios::binary);
+        const Kokkos::Experimental::UmpireTraceFileHeader header;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&corrupted),
+                  sizeof(corrupted));
+      }
+      const bool read = Kokkos::Experimental::umpire_read_trace(file, trace);
+      std::remove(file.c_str());
+      return read;
+    };
+    UmpireTraceRecord corrupted{};
+    corrupted.kind = UmpireTraceKind::Allocate;
+    ASSERT_TRUE(read_corrupted(corrupted));
+    corrupted.kind = static_cast<UmpireTraceKind>(42);
+    ASSERT_FALSE(read_corrupted(corrupted));
+    corrupted.kind  = UmpireTraceKind::Allocate;
+    corrupted.label = 3;
+    ASSERT_FALSE(read_corrupted(corrupted));
+    corrupted.label     = 0;
+    corrupted.allocator = 1;
+    ASSERT_FALSE(read_corrupted(corrupted));
+    // a name longer than the file
+    corrupted.kind  = UmpireTraceKind::Name;
+    corrupted.label = 1;
+    corrupted.bytes = uint64_t(1) << 60;
+    ASSERT_FALSE(read_corrupted(corrupted));
+  }
+
+  void run_arena_tests() {
+    mem_space_host arena = mem_space_host::make_arena(4 * N * sizeof(T));
+
+    T* first_ptr = nullptr;
+    for (int step = 0; step < 3; step++) {
+      {
+        // more than one block worth of temporaries
+        host_view_type a1(view_ctor_prop_host("a1", arena), N);
+        host_view_type a2(view_ctor_prop_host("a2", arena), N);
+        host_view_type a3(view_ctor_prop_host("a3", arena), 4 * N);
+
+        ASSERT_EQ(a1.label(), "a1");
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(a3.data()) %
+                      Kokkos::Impl::MEMORY_ALIGNMENT,
+                  0u);
+
+        Kokkos::parallel_for(
+            Kokkos::RangePolicy<Kokkos::DefaultHostExecutionSpace>(0, N),
+            KOKKOS_LAMBDA(const int i) {
+              a1(i) = i;
+              a2(i) = 2 * i;
+              a3(4 * i) = a1(i) + a2(i);
+            });
+        Kokkos::fence();
+
+        for (int i = 0; i < N; i++) {
+          ASSERT_EQ(a3(4 * i), 3 * i);
+        }
+
+        // after a reset the arena hands out the same memory again
+        if (step == 0) first_ptr = a1.data();
+        ASSERT_EQ(a1.data(), first_ptr);
+
+        // cannot reclaim memory still in use
+        ASSERT_THROW(arena.reset(), std::runtime_error);
+      }
+      arena.reset();
+    }
+  }
 };
 
 TEST(TEST_CATEGORY, umpire_space_view_allocators) {
@@ -76,4 +1111,96 @@ TEST(TEST_CATEGORY, umpire_space_view_allocators) {
   f.run_tests();
 }
 
+TEST(TEST_CATEGORY, umpire_space_alignment) {
+  TestUmpireAllocators<double> f{};
+  f.run_alignment_tests();
+}
+
+#if defined(__linux__)
+TEST(TEST_CATEGORY, umpire_space_huge_pages) {
+  TestUmpireAllocators<double> f{};
+  f.run_huge_page_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_file) {
+  TestUmpireAllocators<double> f{};
+  f.run_file_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_node_shared) {
+  TestUmpireAllocators<double> f{};
+  f.run_shared_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_numa) {
+  TestUmpireAllocators<double> f{};
+  f.run_numa_tests();
+}
+#endif
+
+TEST(TEST_CATEGORY, umpire_space_exec_deep_copy) {
+  TestUmpireAllocators<double> f{};
+  f.run_exec_deep_copy_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_deep_copy_batch) {
+  TestUmpireAllocators<double> f{};
+  f.run_deep_copy_batch_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_statistics) {
+  TestUmpireAllocators<double> f{};
+  f.run_statistics_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_pool_events) {
+  TestUmpireAllocators<double> f{};
+  f.run_pool_event_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_reallocate) {
+  TestUmpireAllocators<double> f{};
+  f.run_reallocate_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_fill) {
+  TestUmpireAllocators<double> f{};
+  f.run_fill_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_prewarm) {
+  TestUmpireAllocators<double> f{};
+  f.run_prewarm_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_size_classes) {
+  TestUmpireAllocators<double> f{};
+  f.run_size_class_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_thread_cache) {
+  TestUmpireAllocators<double> f{};
+  f.run_thread_cache_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_thread_safe) {
+  TestUmpireAllocators<double> f{};
+  f.run_thread_safe_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_release) {
+  TestUmpireAllocators<double> f{};
+  f.run_release_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_trace) {
+  TestUmpireAllocators<double> f{};
+  f.run_trace_tests();
+}
+
+TEST(TEST_CATEGORY, umpire_space_arena) {
+  TestUmpireAllocators<double> f{};
+  f.run_arena_tests();
+}
+
 }  // namespace Test
@@ -47,7 +47,9 @@
 namespace Test {
 
 TEST(TEST_CATEGORY, umpire_space_shared_alloc) {
-  test_shared_alloc<Kokkos::UmpireSpace, TEST_EXECSPACE>();
+  test_shared_alloc<Kokkos::UmpireHostSpace, TEST_EXECSPACE>();
 }
 
 }  // namespace Test
+
+#include <TestUmpireAllocators.hpp>